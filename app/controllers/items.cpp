@@ -0,0 +1,182 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "items.h"
+#include "keysetcursor.h"
+#include "logging.h"
+
+#include <Cutelyst/async.h>
+
+#include <asql-qt6/ASql/adatabase.h>
+#include <asql-qt6/ASql/apool.h>
+#include <asql-qt6/ASql/aresult.h>
+
+#include <QJsonArray>
+#include <QJsonObject>
+
+#include <algorithm>
+
+using namespace Qt::StringLiterals;
+
+namespace {
+
+QJsonObject itemToJson(const ASql::ARow &row)
+{
+    return QJsonObject{
+        {u"id"_s, row.value(0).toLongLong()},
+        {u"feedId"_s, row.value(1).toInt()},
+        {u"placeId"_s, row.value(2).toInt()},
+        {u"title"_s, row.value(3).toString()},
+        {u"description"_s, row.value(4).toString()},
+        {u"author"_s, row.value(5).toString()},
+        {u"link"_s, row.value(6).toString()},
+        {u"pubDate"_s, row.value(7).toDateTime().toString(Qt::ISODate)},
+        {u"data"_s, row.value(8).toJsonObject()}
+    };
+}
+
+int limitParam(Context *c)
+{
+    bool ok = false;
+    const int limit = c->req()->queryParam(u"limit"_s).toInt(&ok);
+    return ok ? std::clamp(limit, 1, 100) : 20;
+}
+
+} // namespace
+
+Items::Items(QObject *parent)
+    : Controller{parent}
+{
+}
+
+void Items::index(Context *c)
+{
+    const int limit = limitParam(c);
+
+    QVariantList params;
+    QStringList where{u"f.enabled"_s};
+
+    bool ok = false;
+    const int feedId = c->req()->queryParam(u"feed"_s).toInt(&ok);
+    if (ok) {
+        params << feedId;
+        where << uR"-(i."feedId" = $)-"_s + QString::number(params.size());
+    }
+
+    const int placeId = c->req()->queryParam(u"place"_s).toInt(&ok);
+    if (ok) {
+        params << placeId;
+        where << uR"-(f."placeId" = $)-"_s + QString::number(params.size());
+    }
+
+    const QString afterStr = c->req()->queryParam(u"after"_s);
+    if (!afterStr.isEmpty()) {
+        const auto after = KeysetCursor::fromString(afterStr);
+        if (!after) {
+            c->res()->setStatus(Response::BadRequest);
+            c->res()->setJsonObjectBody({{u"error"_s, u"invalid after parameter"_s}});
+            return;
+        }
+        QString datePlaceholder;
+        if (after->date.isValid()) {
+            params << after->date;
+            datePlaceholder = u'$' + QString::number(params.size());
+        }
+        params << after->id;
+        const QString idPlaceholder = u'$' + QString::number(params.size());
+        where << after->condition(uR"-(i."pubDate")-"_s, u"i.id"_s, datePlaceholder, idPlaceholder);
+    }
+
+    params << limit;
+    const QString qs = uR"-(SELECT i.id, i."feedId", f."placeId", i.title, i.description, i.author, i.link, i."pubDate", i.data
+                           FROM items i JOIN feeds f ON i."feedId" = f.id WHERE )-"_s
+            + where.join(" AND "_L1)
+            + uR"-( ORDER BY i."pubDate" DESC, i.id DESC LIMIT $)-"_s + QString::number(params.size());
+
+    ASync async{c};
+    ASql::APool::database().exec(qs, params, c, [c, async, limit](ASql::AResult &result) {
+        if (Q_UNLIKELY(result.hasError())) {
+            qCCritical(HBNST_CORE) << "Failed to query items:" << result.errorString();
+            c->res()->setStatus(Response::InternalServerError);
+            c->res()->setJsonObjectBody({{u"error"_s, u"database error"_s}});
+            return;
+        }
+
+        QJsonArray items;
+        KeysetCursor last;
+        for (auto row : result) {
+            last.id = row.value(0).toLongLong();
+            last.date = row.value(7).toDateTime();
+            items.append(itemToJson(row));
+        }
+
+        c->res()->setJsonObjectBody({
+                                        {u"items"_s, items},
+                                        {u"next"_s, items.size() == limit ? QJsonValue{last.toString()} : QJsonValue{}}
+                                    });
+    });
+}
+
+void Items::search(Context *c)
+{
+    const QString term = c->req()->queryParam(u"q"_s).trimmed();
+    if (term.isEmpty()) {
+        c->res()->setStatus(Response::BadRequest);
+        c->res()->setJsonObjectBody({{u"error"_s, u"missing search query"_s}});
+        return;
+    }
+
+    const int limit = limitParam(c);
+
+    QString like = term;
+    like.replace('\\'_L1, "\\\\"_L1).replace('%'_L1, "\\%"_L1).replace('_'_L1, "\\_"_L1);
+    like.prepend('%'_L1);
+    like.append('%'_L1);
+
+    QVariantList params{term, like, limit};
+
+    // see FeedsListItemsCommand for the combined text search query
+    QString qs = uR"-(WITH tsq AS MATERIALIZED (
+                         SELECT string_agg('(' || websearch_to_tsquery(c, $1)::text || ')', ' | ')::tsquery AS q
+                         FROM (SELECT DISTINCT "searchConfig" AS c FROM feeds) cfgs
+                         WHERE numnode(websearch_to_tsquery(c, $1)) > 0)
+                     SELECT i.id, i."feedId", f."placeId", i.title, i.description, i.author, i.link, i."pubDate", i.data
+                     FROM items i JOIN feeds f ON i."feedId" = f.id
+                     WHERE f.enabled AND (i.search @@ (SELECT q FROM tsq) OR i.title ILIKE $2))-"_s;
+
+    bool ok = false;
+    const int feedId = c->req()->queryParam(u"feed"_s).toInt(&ok);
+    if (ok) {
+        params << feedId;
+        qs += uR"-( AND i."feedId" = $)-"_s + QString::number(params.size());
+    }
+
+    const int placeId = c->req()->queryParam(u"place"_s).toInt(&ok);
+    if (ok) {
+        params << placeId;
+        qs += uR"-( AND f."placeId" = $)-"_s + QString::number(params.size());
+    }
+
+    qs += uR"-( ORDER BY ts_rank(i.search, (SELECT q FROM tsq)) DESC NULLS LAST, i."pubDate" DESC LIMIT $3)-"_s;
+
+    ASync async{c};
+    ASql::APool::database().exec(qs, params, c, [c, async](ASql::AResult &result) {
+        if (Q_UNLIKELY(result.hasError())) {
+            qCCritical(HBNST_CORE) << "Failed to search items:" << result.errorString();
+            c->res()->setStatus(Response::InternalServerError);
+            c->res()->setJsonObjectBody({{u"error"_s, u"database error"_s}});
+            return;
+        }
+
+        QJsonArray items;
+        for (auto row : result) {
+            items.append(itemToJson(row));
+        }
+
+        c->res()->setJsonArrayBody(items);
+    });
+}
+
+#include "moc_items.cpp"
@@ -0,0 +1,41 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef HBNST_ITEMS_H
+#define HBNST_ITEMS_H
+
+#include <Cutelyst/Controller>
+
+using namespace Cutelyst;
+
+class Items final : public Controller
+{
+    Q_OBJECT
+public:
+    explicit Items(QObject *parent = nullptr);
+    ~Items() final = default;
+
+    /*!
+     * \brief Returns the latest feed items as JSON object.
+     *
+     * Optional query parameters are \c feed, \c place, \c limit and \c after. The
+     * \c next value of the returned object can be used as \c after to get the next page.
+     */
+    C_ATTR(index, :Path :Args(0))
+    void index(Context *c);
+
+    /*!
+     * \brief Returns the feed items matching the \c q query parameter as JSON array.
+     *
+     * Optional query parameters are \c feed, \c place and \c limit.
+     */
+    C_ATTR(search, :Local :Args(0))
+    void search(Context *c);
+
+private:
+    Q_DISABLE_COPY(Items)
+};
+
+#endif // HBNST_ITEMS_H
@@ -8,6 +8,7 @@
 #include "logging.h"
 #include "settings.h"
 
+#include "controllers/items.h"
 #include "controllers/root.h"
 
 #include <Cutelyst/Engine>
@@ -63,6 +64,7 @@ bool Statalih::init()
 #endif
 
     new Root(this);
+    new Items(this);
 
     qCDebug(HBNST_CORE) << "Static plugin:" << Settings::staticPlugin();
     if (Settings::staticPlugin() != Settings::StaticPlugin::None) {
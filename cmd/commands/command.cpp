@@ -218,10 +218,13 @@ void Command::exit(CLI::RC rc) const
     qApp->exit(static_cast<int>(rc));
 }
 
-void Command::addOutputFormatOption()
+void Command::addOutputFormatOption(bool withNdjson)
 {
     QLocale locale;
-    const QStringList formats({u"table"_s, u"json"_s, u"json-pretty"_s});
+    QStringList formats({u"table"_s, u"json"_s, u"json-pretty"_s});
+    if (withNdjson) {
+        formats << u"ndjson"_s;
+    }
     m_cliOptions.emplace_back(QStringList({u"f"_s, u"format"_s}),
                                   //: CLI option description
                                   //% "Render output in a particular format. Available: %1. Default: %2."
@@ -232,5 +235,35 @@ void Command::addOutputFormatOption()
                                   formats.first());
 }
 
+void Command::addPaginationOptions(const QString &afterDescription, const QString &afterValueName)
+{
+    m_cliOptions.emplace_back(QStringList({u"l"_s, u"limit"_s}),
+                              //: CLI option description
+                              //% "Maximum number of results to show."
+                              qtTrId("statalihcmd-opt-limit-desc"),
+                              // source string defined in feedsupdatecommand.cpp
+                              qtTrId("statalihcmd-opt-value-number"));
+
+    m_cliOptions.emplace_back(QStringList({u"a"_s, u"after"_s}), afterDescription, afterValueName);
+}
+
+std::optional<int> Command::parseLimit(QCommandLineParser *parser)
+{
+    const QString limitStr = parser->value(u"limit"_s);
+    if (limitStr.isEmpty()) {
+        return 0;
+    }
+
+    bool ok = false;
+    const int limit = limitStr.toInt(&ok);
+    if (!ok || limit < 1) {
+        printFailed();
+        //% "Invalid limit. Has to be a number greater than 0."
+        exit(inputError(qtTrId("statalihcmd-err-invalid-limit")));
+        return std::nullopt;
+    }
+
+    return limit;
+}
 
 #include "moc_command.cpp"
@@ -9,6 +9,8 @@
 #include <database.h>
 #include <QCommandLineOption>
 
+#include <optional>
+
 class QCommandLineParser;
 class QTextStream;
 
@@ -44,7 +46,26 @@ protected:
     void runSubCommand(const QString &command, QCommandLineParser *parser);
     void showInvalidCommand(const QString &command) const;
     void exit(CLI::RC rc) const;
-    void addOutputFormatOption();
+    /*!
+     * \brief Adds the \c --format option.
+     *
+     * If \a withNdjson is \c true, \c ndjson is available as format for commands
+     * that list multiple objects.
+     */
+    void addOutputFormatOption(bool withNdjson = false);
+
+    /*!
+     * \brief Adds the \c --limit option and the \c --after option described by \a afterDescription.
+     */
+    void addPaginationOptions(const QString &afterDescription, const QString &afterValueName);
+
+    /*!
+     * \brief Returns the value of the \c --limit option, \c 0 if it is not set.
+     *
+     * If the value is invalid, the command will exit with an input error and
+     * \c std::nullopt is returned.
+     */
+    [[nodiscard]] std::optional<int> parseLimit(QCommandLineParser *parser);
 
     QList<QCommandLineOption> m_cliOptions;
 
@@ -12,6 +12,13 @@
 #include "dbmigrations/m0001_createplacestable.h"
 #include "dbmigrations/m0002_createfeedstable.h"
 #include "dbmigrations/m0003_createitemstable.h"
+#include "dbmigrations/m0004_addfeedscachevalidators.h"
+#include "dbmigrations/m0005_addfeedscontenthash.h"
+#include "dbmigrations/m0006_addfeedsnextfetch.h"
+#include "dbmigrations/m0007_createopengraphtable.h"
+#include "dbmigrations/m0008_addlistingindexes.h"
+#include "dbmigrations/m0009_additemssearch.h"
+#include "dbmigrations/m0010_additemskeysetindexes.h"
 
 #include <Firfuorida/Migrator>
 
@@ -70,6 +77,13 @@ void DatabaseCommand::initMigrations()
     new M0001_CreatePlacesTable(m_migrator.get());
     new M0002_CreateFeedsTable(m_migrator.get());
     new M0003_CreateItemsTable(m_migrator.get());
+    new M0004_AddFeedsCacheValidators(m_migrator.get());
+    new M0005_AddFeedsContentHash(m_migrator.get());
+    new M0006_AddFeedsNextFetch(m_migrator.get());
+    new M0007_CreateOpenGraphTable(m_migrator.get());
+    new M0008_AddListingIndexes(m_migrator.get());
+    new M0009_AddItemsSearch(m_migrator.get());
+    new M0010_AddItemsKeysetIndexes(m_migrator.get());
 }
 
 void DatabaseCommand::init()
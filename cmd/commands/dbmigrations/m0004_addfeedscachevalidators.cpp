@@ -0,0 +1,38 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "m0004_addfeedscachevalidators.h"
+
+using namespace Qt::StringLiterals;
+
+M0004_AddFeedsCacheValidators::M0004_AddFeedsCacheValidators(Firfuorida::Migrator *parent)
+    : Firfuorida::Migration{parent}
+{
+
+}
+
+void M0004_AddFeedsCacheValidators::up()
+{
+    if (dbType() == Firfuorida::Migrator::PSQL) {
+        raw(uR"-(
+            ALTER TABLE feeds
+                ADD COLUMN etag TEXT,
+                ADD COLUMN "lastModified" TEXT
+        )-"_s);
+    }
+}
+
+void M0004_AddFeedsCacheValidators::down()
+{
+    if (dbType() == Firfuorida::Migrator::PSQL) {
+        raw(uR"-(
+            ALTER TABLE feeds
+                DROP COLUMN etag,
+                DROP COLUMN "lastModified"
+        )-"_s);
+    }
+}
+
+#include "moc_m0004_addfeedscachevalidators.cpp"
@@ -0,0 +1,30 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "m0005_addfeedscontenthash.h"
+
+using namespace Qt::StringLiterals;
+
+M0005_AddFeedsContentHash::M0005_AddFeedsContentHash(Firfuorida::Migrator *parent)
+    : Firfuorida::Migration{parent}
+{
+
+}
+
+void M0005_AddFeedsContentHash::up()
+{
+    if (dbType() == Firfuorida::Migrator::PSQL) {
+        raw(uR"-(ALTER TABLE feeds ADD COLUMN "contentHash" BYTEA)-"_s);
+    }
+}
+
+void M0005_AddFeedsContentHash::down()
+{
+    if (dbType() == Firfuorida::Migrator::PSQL) {
+        raw(uR"-(ALTER TABLE feeds DROP COLUMN "contentHash")-"_s);
+    }
+}
+
+#include "moc_m0005_addfeedscontenthash.cpp"
@@ -0,0 +1,23 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef M0005_ADDFEEDSCONTENTHASH_H
+#define M0005_ADDFEEDSCONTENTHASH_H
+
+#include <Firfuorida/Migration>
+
+class M0005_AddFeedsContentHash final : public Firfuorida::Migration
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(M0005_AddFeedsContentHash)
+public:
+    explicit M0005_AddFeedsContentHash(Firfuorida::Migrator *parent);
+    ~M0005_AddFeedsContentHash() override = default;
+
+    void up() final;
+    void down() final;
+};
+
+#endif // M0005_ADDFEEDSCONTENTHASH_H
@@ -0,0 +1,32 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "m0006_addfeedsnextfetch.h"
+
+using namespace Qt::StringLiterals;
+
+M0006_AddFeedsNextFetch::M0006_AddFeedsNextFetch(Firfuorida::Migrator *parent)
+    : Firfuorida::Migration{parent}
+{
+
+}
+
+void M0006_AddFeedsNextFetch::up()
+{
+    if (dbType() == Firfuorida::Migrator::PSQL) {
+        raw(uR"-(ALTER TABLE feeds ADD COLUMN "nextFetch" TIMESTAMP)-"_s);
+        raw(uR"-(CREATE INDEX "feeds_nextFetch_idx" ON feeds ("nextFetch") WHERE enabled = true)-"_s);
+    }
+}
+
+void M0006_AddFeedsNextFetch::down()
+{
+    if (dbType() == Firfuorida::Migrator::PSQL) {
+        raw(uR"-(DROP INDEX IF EXISTS "feeds_nextFetch_idx")-"_s);
+        raw(uR"-(ALTER TABLE feeds DROP COLUMN "nextFetch")-"_s);
+    }
+}
+
+#include "moc_m0006_addfeedsnextfetch.cpp"
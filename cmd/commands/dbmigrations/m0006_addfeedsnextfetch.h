@@ -0,0 +1,23 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef M0006_ADDFEEDSNEXTFETCH_H
+#define M0006_ADDFEEDSNEXTFETCH_H
+
+#include <Firfuorida/Migration>
+
+class M0006_AddFeedsNextFetch final : public Firfuorida::Migration
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(M0006_AddFeedsNextFetch)
+public:
+    explicit M0006_AddFeedsNextFetch(Firfuorida::Migrator *parent);
+    ~M0006_AddFeedsNextFetch() override = default;
+
+    void up() final;
+    void down() final;
+};
+
+#endif // M0006_ADDFEEDSNEXTFETCH_H
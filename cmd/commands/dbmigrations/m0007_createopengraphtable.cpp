@@ -0,0 +1,36 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "m0007_createopengraphtable.h"
+
+using namespace Qt::StringLiterals;
+
+M0007_CreateOpenGraphTable::M0007_CreateOpenGraphTable(Firfuorida::Migrator *parent)
+    : Firfuorida::Migration{parent}
+{
+
+}
+
+void M0007_CreateOpenGraphTable::up()
+{
+    if (dbType() == Firfuorida::Migrator::PSQL) {
+        raw(uR"-(CREATE TABLE opengraph (
+                    link VARCHAR(2048) PRIMARY KEY,
+                    "fetchedAt" TIMESTAMP NOT NULL,
+                    etag VARCHAR(255),
+                    "lastModified" VARCHAR(64),
+                    image JSONB
+                ))-"_s);
+    }
+}
+
+void M0007_CreateOpenGraphTable::down()
+{
+    if (dbType() == Firfuorida::Migrator::PSQL) {
+        raw(uR"-(DROP TABLE IF EXISTS opengraph)-"_s);
+    }
+}
+
+#include "moc_m0007_createopengraphtable.cpp"
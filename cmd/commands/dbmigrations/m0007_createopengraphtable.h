@@ -0,0 +1,23 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef M0007_CREATEOPENGRAPHTABLE_H
+#define M0007_CREATEOPENGRAPHTABLE_H
+
+#include <Firfuorida/Migration>
+
+class M0007_CreateOpenGraphTable final : public Firfuorida::Migration
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(M0007_CreateOpenGraphTable)
+public:
+    explicit M0007_CreateOpenGraphTable(Firfuorida::Migrator *parent);
+    ~M0007_CreateOpenGraphTable() override = default;
+
+    void up() final;
+    void down() final;
+};
+
+#endif // M0007_CREATEOPENGRAPHTABLE_H
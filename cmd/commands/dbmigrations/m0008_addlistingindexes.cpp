@@ -0,0 +1,38 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "m0008_addlistingindexes.h"
+
+using namespace Qt::StringLiterals;
+
+M0008_AddListingIndexes::M0008_AddListingIndexes(Firfuorida::Migrator *parent)
+    : Firfuorida::Migration{parent}
+{
+
+}
+
+void M0008_AddListingIndexes::up()
+{
+    if (dbType() == Firfuorida::Migrator::PSQL) {
+        // the foreign key constraints of M0001 and M0002 are named *_idx but do not create indexes
+        // id is part of the index for the keyset pagination of item listings, see KeysetCursor
+        raw(uR"-(CREATE INDEX "items_feedId_pubDate_id_idx" ON items ("feedId", "pubDate" DESC, id DESC))-"_s);
+        raw(uR"-(CREATE INDEX "feeds_placeId_fk_idx" ON feeds ("placeId"))-"_s);
+        raw(uR"-(CREATE INDEX "places_parent_fk_idx" ON places (parent))-"_s);
+        raw(uR"-(CREATE UNIQUE INDEX "places_slug_idx" ON places (slug))-"_s);
+    }
+}
+
+void M0008_AddListingIndexes::down()
+{
+    if (dbType() == Firfuorida::Migrator::PSQL) {
+        raw(uR"-(DROP INDEX IF EXISTS "places_slug_idx")-"_s);
+        raw(uR"-(DROP INDEX IF EXISTS "places_parent_fk_idx")-"_s);
+        raw(uR"-(DROP INDEX IF EXISTS "feeds_placeId_fk_idx")-"_s);
+        raw(uR"-(DROP INDEX IF EXISTS "items_feedId_pubDate_id_idx")-"_s);
+    }
+}
+
+#include "moc_m0008_addlistingindexes.cpp"
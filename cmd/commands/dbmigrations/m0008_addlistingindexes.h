@@ -0,0 +1,23 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef M0008_ADDLISTINGINDEXES_H
+#define M0008_ADDLISTINGINDEXES_H
+
+#include <Firfuorida/Migration>
+
+class M0008_AddListingIndexes final : public Firfuorida::Migration
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(M0008_AddListingIndexes)
+public:
+    explicit M0008_AddListingIndexes(Firfuorida::Migrator *parent);
+    ~M0008_AddListingIndexes() override = default;
+
+    void up() final;
+    void down() final;
+};
+
+#endif // M0008_ADDLISTINGINDEXES_H
@@ -0,0 +1,64 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "m0009_additemssearch.h"
+
+using namespace Qt::StringLiterals;
+
+M0009_AddItemsSearch::M0009_AddItemsSearch(Firfuorida::Migrator *parent)
+    : Firfuorida::Migration{parent}
+{
+
+}
+
+void M0009_AddItemsSearch::up()
+{
+    if (dbType() == Firfuorida::Migrator::PSQL) {
+        raw(uR"-(CREATE EXTENSION IF NOT EXISTS pg_trgm)-"_s);
+
+        raw(uR"-(ALTER TABLE feeds ADD COLUMN "searchConfig" REGCONFIG NOT NULL DEFAULT 'simple')-"_s);
+        raw(uR"-(ALTER TABLE items ADD COLUMN search TSVECTOR)-"_s);
+
+        // a generated column can not use the text search configuration of the feed,
+        // so the search vector is set by a trigger
+        raw(uR"-(
+            CREATE FUNCTION items_search_update() RETURNS trigger AS $$
+            DECLARE
+                cfg REGCONFIG;
+            BEGIN
+                SELECT "searchConfig" INTO cfg FROM feeds WHERE id = NEW."feedId";
+                cfg := COALESCE(cfg, 'simple');
+                NEW.search := setweight(to_tsvector(cfg, COALESCE(NEW.title, '')), 'A')
+                           || setweight(to_tsvector(cfg, COALESCE(NEW.description, '')), 'B');
+                RETURN NEW;
+            END
+            $$ LANGUAGE plpgsql
+        )-"_s);
+        raw(uR"-(CREATE TRIGGER items_search_trigger BEFORE INSERT OR UPDATE OF title, description, "feedId" ON items FOR EACH ROW EXECUTE FUNCTION items_search_update())-"_s);
+
+        raw(uR"-(
+            UPDATE items i SET search = setweight(to_tsvector(f."searchConfig", COALESCE(i.title, '')), 'A')
+                                     || setweight(to_tsvector(f."searchConfig", COALESCE(i.description, '')), 'B')
+            FROM feeds f WHERE f.id = i."feedId"
+        )-"_s);
+
+        raw(uR"-(CREATE INDEX items_search_idx ON items USING GIN (search))-"_s);
+        raw(uR"-(CREATE INDEX items_title_trgm_idx ON items USING GIN (title gin_trgm_ops))-"_s);
+    }
+}
+
+void M0009_AddItemsSearch::down()
+{
+    if (dbType() == Firfuorida::Migrator::PSQL) {
+        raw(uR"-(DROP INDEX IF EXISTS items_title_trgm_idx)-"_s);
+        raw(uR"-(DROP INDEX IF EXISTS items_search_idx)-"_s);
+        raw(uR"-(DROP TRIGGER IF EXISTS items_search_trigger ON items)-"_s);
+        raw(uR"-(DROP FUNCTION IF EXISTS items_search_update())-"_s);
+        raw(uR"-(ALTER TABLE items DROP COLUMN search)-"_s);
+        raw(uR"-(ALTER TABLE feeds DROP COLUMN "searchConfig")-"_s);
+    }
+}
+
+#include "moc_m0009_additemssearch.cpp"
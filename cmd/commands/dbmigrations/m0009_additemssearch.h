@@ -0,0 +1,23 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef M0009_ADDITEMSSEARCH_H
+#define M0009_ADDITEMSSEARCH_H
+
+#include <Firfuorida/Migration>
+
+class M0009_AddItemsSearch final : public Firfuorida::Migration
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(M0009_AddItemsSearch)
+public:
+    explicit M0009_AddItemsSearch(Firfuorida::Migrator *parent);
+    ~M0009_AddItemsSearch() override = default;
+
+    void up() final;
+    void down() final;
+};
+
+#endif // M0009_ADDITEMSSEARCH_H
@@ -0,0 +1,31 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "m0010_additemskeysetindexes.h"
+
+using namespace Qt::StringLiterals;
+
+M0010_AddItemsKeysetIndexes::M0010_AddItemsKeysetIndexes(Firfuorida::Migrator *parent)
+    : Firfuorida::Migration{parent}
+{
+
+}
+
+void M0010_AddItemsKeysetIndexes::up()
+{
+    if (dbType() == Firfuorida::Migrator::PSQL) {
+        // item listings are paginated by ("pubDate", id), see KeysetCursor
+        raw(uR"-(CREATE INDEX "items_pubDate_id_idx" ON items ("pubDate" DESC, id DESC))-"_s);
+    }
+}
+
+void M0010_AddItemsKeysetIndexes::down()
+{
+    if (dbType() == Firfuorida::Migrator::PSQL) {
+        raw(uR"-(DROP INDEX IF EXISTS "items_pubDate_id_idx")-"_s);
+    }
+}
+
+#include "moc_m0010_additemskeysetindexes.cpp"
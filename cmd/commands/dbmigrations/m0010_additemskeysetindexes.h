@@ -0,0 +1,23 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef M0010_ADDITEMSKEYSETINDEXES_H
+#define M0010_ADDITEMSKEYSETINDEXES_H
+
+#include <Firfuorida/Migration>
+
+class M0010_AddItemsKeysetIndexes final : public Firfuorida::Migration
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(M0010_AddItemsKeysetIndexes)
+public:
+    explicit M0010_AddItemsKeysetIndexes(Firfuorida::Migrator *parent);
+    ~M0010_AddItemsKeysetIndexes() override = default;
+
+    void up() final;
+    void down() final;
+};
+
+#endif // M0010_ADDITEMSKEYSETINDEXES_H
@@ -5,17 +5,18 @@
 
 #include "feedsaddcommand.h"
 #include "feedparser.h"
+#include "feedstore.h"
+#include "hostscheduler.h"
 #include "itemimageextractor.h"
+#include "itemstore.h"
+#include "logging.h"
 #include "utils.h"
 
 #include <QCommandLineParser>
 #include <QCommandLineOption>
-#include <QDomDocument>
-#include <QDomElement>
 #include <QHttpHeaders>
 #include <QJsonDocument>
 #include <QJsonObject>
-#include <QJsonValue>
 #include <QLocale>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
@@ -200,7 +201,12 @@ void FeedsAddCommand::exec(QCommandLineParser *parser)
     const QString userAgent = QCoreApplication::applicationName() + '/'_L1 + QCoreApplication::applicationVersion();
     request.setHeader(QNetworkRequest::UserAgentHeader, userAgent);
     request.setUrl(url);
-    nam->get(request);
+
+    // parse the feed while it is downloaded
+    m_parser = new FeedParser(this);
+    m_parser->setFallbackSource(url);
+    connect(m_parser, &FeedParser::feedParsed, this, &FeedsAddCommand::feedParsed);
+    m_parser->parse(nam->get(request));
 }
 
 void FeedsAddCommand::feedFetched(QNetworkReply *reply)
@@ -210,37 +216,15 @@ void FeedsAddCommand::feedFetched(QNetworkReply *reply)
     if (reply->error() == QNetworkReply::NoError) {
         printDone();
 
-        m_etag = reply->header(QNetworkRequest::ETagHeader).toString();
+        // keep the validators verbatim to send them back as conditional headers on updates
+        m_etag = QString::fromLatin1(reply->rawHeader("ETag"_ba));
+        m_lastModified = QString::fromLatin1(reply->rawHeader("Last-Modified"_ba));
 
         //: Satus message
         //% "Parsing XML"
         printStatus(qtTrId("statlihcmd-status-feed-add-parse-xml"));
 
-        QDomDocument doc;
-#if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
-        auto parseResult = doc.setContent(reply, QDomDocument::ParseOption::UseNamespaceProcessing);
-        if (Q_UNLIKELY(!parseResult)) {
-            //: Error message, %1 and %2 will be replaced by line and column,
-            //: %3 by the error message of the parser
-            //% "Failed to parse feed XML data at line %1 and column %2: %3"
-            exit(parsingError(qtTrId("statlihcmd-err-feeds-add-parsing").arg(QString::number(parseResult.errorLine), QString::number(parseResult.errorColumn), parseResult.errorMessage)));
-            return;
-        }
-#else
-        QString errorMsg;
-        int errorLine{-1};
-        int errorColumn{-1};
-        if (Q_UNLIKELY(!doc.setContent(reply, true, &errorMsg, &errorLine, &errorColumn))) {
-            printFailed();
-            exit(parsingError(qtTrId("statlihcmd-err-feeds-add-parsing").arg(QString::number(errorLine), QString::number(errorColumn), errorMsg)));
-            return;
-        }
-#endif
-
-        auto parser = new FeedParser(this);
-        connect(parser, &FeedParser::feedParsed, this, &FeedsAddCommand::feedParsed);
-        connect(parser, &FeedParser::feedParsed, parser, &QObject::deleteLater);
-        parser->parse(doc);
+        m_parser->finish();
     } else {
         printFailed();
         exit(networkError(reply));
@@ -249,9 +233,29 @@ void FeedsAddCommand::feedFetched(QNetworkReply *reply)
 
 void FeedsAddCommand::feedParsed(const Feed &feed)
 {
+    m_parser->deleteLater();
+
+    if (Q_UNLIKELY(m_parser->hasError())) {
+        printFailed();
+        //: Error message, %1 and %2 will be replaced by line and column,
+        //: %3 by the error message of the parser
+        //% "Failed to parse feed XML data at line %1 and column %2: %3"
+        exit(parsingError(qtTrId("statlihcmd-err-feeds-add-parsing").arg(QString::number(m_parser->errorLine()), QString::number(m_parser->errorColumn()), m_parser->errorString())));
+        return;
+    }
+
+    if (Q_UNLIKELY(!feed.isValid())) {
+        printFailed();
+        //: Error message
+        //% "The fetched data does not contain a supported web feed."
+        exit(parsingError(qtTrId("statlihcmd-err-feeds-add-invalid-feed")));
+        return;
+    }
+
     printDone();
 
     m_feed = feed;
+    m_contentHash = m_parser->contentHash();
 
     //% "Adding new web feed"
     printStatus(qtTrId("statalihcmd-status-feeds-add-db-add"));
@@ -279,70 +283,57 @@ void FeedsAddCommand::feedParsed(const Feed &feed)
         return;
     }
 
-    if (Q_UNLIKELY(!q.prepare(uR"-(INSERT INTO feeds ("placeId", slug, title, description, source, link, "lastBuildDate", "lastFetch", created, data)
-                              VALUES (:placeId, :slug, :title, :description, :source, :link, :lastBuildDate, :lastFetch, :created, :data)
-                              RETURNING id)-"_s))) {
-        printFailed();
-        exit(dbError(q));
-        return;
-    }
-
     m_title = m_overrideTitle.isEmpty() ? m_feed.title() : m_overrideTitle;
     m_slug = m_overrideSlug.isEmpty() ? Utils::slugify(m_title) : Utils::slugify(m_overrideSlug);
     m_description = m_overrideDescription.isEmpty() ? Utils::cleanDescription(m_feed.description()) : m_overrideDescription;
 
-    q.bindValue(u":placeId"_s, m_placeId);
-    q.bindValue(u":slug"_s, m_slug);
-    q.bindValue(u":title"_s, m_title);
-    q.bindValue(u":description"_s, m_description);
-    q.bindValue(u":source"_s, m_feed.source());
-    q.bindValue(u":link"_s, m_feed.link());
-    q.bindValue(u":lastBuildDate"_s, m_feed.lastBuildDate());
-    q.bindValue(u":lastFetch"_s, QDateTime::currentDateTimeUtc());
-    q.bindValue(u":created"_s, QDateTime::currentDateTimeUtc());
-    q.bindValue(u":data"_s, QJsonObject());
-
-    if (Q_UNLIKELY(!q.exec())) {
+    FeedStore::NewFeed newFeed;
+    newFeed.feed = m_feed;
+    newFeed.placeId = m_placeId;
+    newFeed.slug = m_slug;
+    newFeed.title = m_title;
+    newFeed.description = m_description;
+    newFeed.etag = m_etag;
+    newFeed.lastModified = m_lastModified;
+    newFeed.contentHash = m_contentHash;
+
+    // the feed and all of its items are written in one transaction
+    FeedStore store{HBNST_DBCONNAME};
+    store.loadConfig(this);
+    const auto feedId = store.insert(newFeed);
+    if (Q_UNLIKELY(!feedId)) {
         printFailed();
-        exit(dbError(q));
+        exit(dbError(store.lastError()));
         return;
     }
 
-    if (Q_UNLIKELY(!q.next())) {
+    if (Q_UNLIKELY(*feedId == 0)) {
+        // the feed has been added by someone else since the check above
         printFailed();
-        exit(dbError(q));
+        //% "This web feed has already been added to the database."
+        exit(inputError(qtTrId("statalihcmd-err-feeds-add-already-added-concurrently")));
         return;
     }
 
-    m_feedId = q.value(0).toInt();
-
-    if (Q_UNLIKELY(!q.prepare(uR"-(INSERT INTO items ("feedId", guid, title, description, author, link, "pubDate")
-                              VALUES (:feedId, :guid, :title, :description, :author, :link, :pubDate))-"_s))) {
-        printFailed();
-        exit(dbError(q));
-        return;
-    }
-
-    const QList<FeedItem> items = m_feed.items();
-    for (const auto &item : items) {
-        q.bindValue(u":feedId"_s, m_feedId);
-        q.bindValue(u":guid"_s, item.guid());
-        q.bindValue(u":title"_s, item.title());
-        q.bindValue(u":description"_s, Utils::cleanDescription(item.description()));
-        q.bindValue(u":author"_s, item.author());
-        q.bindValue(u":link"_s, item.link());
-        q.bindValue(u":pubDate"_s, item.pubDate());
-
-        q.exec();
-    }
+    m_feedId = *feedId;
 
     printDone();
 
     //% "Fetching item images"
     printStatus(qtTrId("statalihcmd-status-feeds-add-fetch-imgs"));
 
-    auto iie = new ItemImageExtractor(this);
-    connect(iie, &ItemImageExtractor::finished, this, &FeedsAddCommand::imagesFetched);
+    auto scheduler = new HostScheduler(this);
+    scheduler->loadConfig(this);
+    auto iie = new ItemImageExtractor(scheduler, this);
+    iie->loadConfig(this);
+    iie->setCacheConnectionName(HBNST_DBCONNAME);
+    connect(iie, &ItemImageExtractor::finished, this, [this, iie](const QVariantMap &itemImages, const QMap<QString,QString> &errors){
+        ItemStore store{HBNST_DBCONNAME};
+        if (Q_UNLIKELY(!store.addImageStats(m_feedId, iie->imagesFromFeed(), iie->pagesScraped()))) {
+            qCWarning(ST_UPDATER).noquote() << "Failed to update image statistics of feed" << m_feedId << "in the database:" << store.lastError().text();
+        }
+        imagesFetched(itemImages, errors);
+    });
     iie->start(m_feed.items());
 
 }
@@ -367,35 +358,15 @@ void FeedsAddCommand::imagesFetched(const QVariantMap &itemImages, const QMap<QS
 
     if (!itemImages.empty()) {
 
-        QSqlQuery q(QSqlDatabase::database(HBNST_DBCONNAME));
-
-        bool ok = q.prepare(uR"-(UPDATE items SET data = :data WHERE guid = :guid)-"_s);
-
-        if (ok) {
-            QStringList queryErrors;
-            for (auto i = itemImages.constBegin(), end = itemImages.constEnd(); i != end; ++i) {
-                const QString guid = i.key();
-                const QJsonObject imgData({
-                                              {u"image"_s, QJsonObject::fromVariantMap(i.value().toMap())}
-                                          });
-                q.bindValue(u":guid"_s, guid);
-                q.bindValue(u":data"_s, QString::fromUtf8(QJsonDocument(imgData).toJson(QJsonDocument::Compact)));
-
-                if (!q.exec()) {
-                    qDebug() << q.lastError().text();
-                    queryErrors << q.lastError().text();
-                }
-            }
-
-            if (queryErrors.empty()) {
-                printDone();
-            } else {
-                printFailed();
-                printError(queryErrors);
-            }
+        auto db = QSqlDatabase::database(HBNST_DBCONNAME);
+        ItemStore store{HBNST_DBCONNAME};
+        if (Q_LIKELY(db.transaction() && store.setImages(itemImages) && db.commit())) {
+            printDone();
         } else {
+            const QString error = store.lastError().isValid() ? store.lastError().text() : db.lastError().text();
+            db.rollback();
             printFailed();
-            printError(q.lastError().text());
+            printError(error);
         }
     }
 
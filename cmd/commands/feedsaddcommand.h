@@ -9,6 +9,7 @@
 #include "command.h"
 #include "feed.h"
 
+class FeedParser;
 class QUrl;
 class QNetworkReply;
 
@@ -34,6 +35,7 @@ private:
     void init();
 
     Feed m_feed;
+    FeedParser *m_parser{nullptr};
     QString m_overrideTitle;
     QString m_title;
     QString m_overrideSlug;
@@ -42,6 +44,8 @@ private:
     QString m_description;
     QString m_format;
     QString m_etag;
+    QString m_lastModified;
+    QByteArray m_contentHash;
     int m_feedId{0};
     int m_placeId{0};
 
@@ -5,7 +5,9 @@
 
 #include "feedscommand.h"
 #include "feedsaddcommand.h"
+#include "feedsimportcommand.h"
 #include "feedsupdatecommand.h"
+#include "feedswatchcommand.h"
 #include "feedslistcommand.h"
 #include "feedslistitemscommand.h"
 
@@ -56,7 +58,9 @@ QString FeedsCommand::description() const
 void FeedsCommand::init()
 {
     new FeedsAddCommand(this);
+    new FeedsImportCommand(this);
     new FeedsUpdateCommand(this);
+    new FeedsWatchCommand(this);
     new FeedsListCommand(this);
     new FeedsListItemsCommand(this);
 }
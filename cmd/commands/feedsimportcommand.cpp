@@ -0,0 +1,469 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "feedsimportcommand.h"
+#include "feedparser.h"
+#include "feedstore.h"
+#include "hostscheduler.h"
+#include "itemimageextractor.h"
+#include "itemstore.h"
+#include "logging.h"
+#include "utils.h"
+
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QLocale>
+#include <QMetaObject>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QXmlStreamReader>
+
+#include <QDebug>
+
+using namespace Qt::Literals::StringLiterals;
+
+#define HBNST_DBCONNAME u"dbcon"_s
+
+FeedsImportCommand::FeedsImportCommand(QObject *parent)
+    : Command{parent}
+{
+    setObjectName("import");
+}
+
+void FeedsImportCommand::init()
+{
+    m_cliOptions.emplace_back(QStringList({u"o"_s, u"opml"_s}),
+                              //: CLI option description
+                              //% "Path to the OPML file containing the web feeds to import."
+                              qtTrId("statalihcmd-opt-feeds-import-opml-desc"),
+                              //: CLI option value name
+                              //% "file"
+                              qtTrId("statalihcmd-opt-value-file"));
+
+    m_cliOptions.emplace_back(QStringList({u"p"_s, u"place"_s}),
+                              //: CLI option description
+                              //% "Database ID of the place the imported feeds belong to."
+                              qtTrId("statalihcmd-opt-feeds-import-place-desc"),
+                              // source string defined in placesaddcommand.cpp
+                              qtTrId("statlihcmd-opt-value-dbid"));
+
+    m_cliOptions.emplace_back(QStringList({u"c"_s, u"concurrency"_s}),
+                              //: CLI option description
+                              //% "Number of feeds that will be fetched in parallel. Default: 4."
+                              qtTrId("statalihcmd-opt-feeds-import-concurrency-desc"),
+                              // source string defined in feedsupdatecommand.cpp
+                              qtTrId("statalihcmd-opt-value-number"),
+                              u"4"_s);
+}
+
+void FeedsImportCommand::exec(QCommandLineParser *parser)
+{
+    init();
+
+    parser->addOptions(m_cliOptions);
+    parser->parse(QCoreApplication::arguments());
+
+    if (checkShowHelp(parser)) {
+        exit(RC::OK);
+        return;
+    }
+
+    setGlobalOptions(parser);
+
+    // source string defined in feedsaddcommand.cpp
+    printStatus(qtTrId("statalihcmd-status-parsing-input"));
+
+    const QString opmlFile = parser->value(u"opml"_s).trimmed();
+    if (opmlFile.isEmpty()) {
+        printFailed();
+        //: Error message
+        //% "Please use the --opml parameter to specify the OPML file to import."
+        exit(inputError(qtTrId("statalihcmd-err-feeds-import-missing-opml")));
+        return;
+    }
+
+    bool ok = false;
+    m_placeId = parser->value(u"place"_s).trimmed().toInt(&ok);
+    if (!ok || m_placeId < 1) {
+        printFailed();
+        // source string defined in feedsaddcommand.cpp
+        exit(inputError(qtTrId("statalihcmd-err-feeds-add-invalid-place-id")));
+        return;
+    }
+
+    m_concurrency = parser->value(u"concurrency"_s).toInt(&ok);
+    if (!ok || m_concurrency < 1) {
+        printFailed();
+        // source string defined in feedsupdatecommand.cpp
+        exit(inputError(qtTrId("statalihcmd-err-feeds-update-invalid-concurrency")));
+        return;
+    }
+
+    printDone();
+
+    CLI::RC rc = openDb(HBNST_DBCONNAME);
+    if (rc != RC::OK) {
+        exit(rc);
+        return;
+    }
+
+    // source string defined in feedsaddcommand.cpp
+    printStatus(qtTrId("statalihcmd-status-feeds-add-checking-db"));
+
+    if (!loadExisting()) {
+        return;
+    }
+
+    printDone();
+
+    //: Status message
+    //% "Reading OPML file"
+    printStatus(qtTrId("statalihcmd-status-feeds-import-reading-opml"));
+
+    if (!readOpml(opmlFile)) {
+        return;
+    }
+
+    printDone();
+
+    if (m_feedsToImport.empty()) {
+        //% "The OPML file does not contain any new web feeds."
+        printWarning(qtTrId("statalihcmd-warn-feeds-import-nothing-to-import"));
+        importFinished();
+        return;
+    }
+
+    // all feeds share the same scheduler, so requests to the same host are rate limited
+    // across feeds and the connections to the hosts are reused
+    m_scheduler = new HostScheduler(this);
+    m_scheduler->loadConfig(this);
+
+    QMetaObject::invokeMethod(this, &FeedsImportCommand::importFeed, Qt::QueuedConnection);
+}
+
+bool FeedsImportCommand::loadExisting()
+{
+    QSqlQuery q{QSqlDatabase::database(HBNST_DBCONNAME)};
+
+    if (Q_UNLIKELY(!q.prepare(u"SELECT id FROM places WHERE id = :id"_s))) {
+        printFailed();
+        exit(dbError(q));
+        return false;
+    }
+
+    q.bindValue(u":id"_s, m_placeId);
+
+    if (Q_UNLIKELY(!q.exec())) {
+        printFailed();
+        exit(dbError(q));
+        return false;
+    }
+
+    if (!q.next()) {
+        printFailed();
+        // source string defined in feedsaddcommand.cpp
+        exit(inputError(qtTrId("statalihcmd-err-feeds-add-unknown-place").arg(m_placeId)));
+        return false;
+    }
+
+    // sources and slugs are loaded once, so the feeds of the OPML file can be
+    // checked without a database round trip per feed
+    q.setForwardOnly(true);
+
+    if (Q_UNLIKELY(!q.exec(u"SELECT source, slug FROM feeds"_s))) {
+        printFailed();
+        exit(dbError(q));
+        return false;
+    }
+
+    while (q.next()) {
+        m_sources.insert(q.value(0).toString());
+        m_slugs.insert(q.value(1).toString());
+    }
+
+    return true;
+}
+
+bool FeedsImportCommand::readOpml(const QString &fileName)
+{
+    QFile file{fileName};
+    if (Q_UNLIKELY(!file.open(QIODevice::ReadOnly))) {
+        printFailed();
+        //: Error message, %1 will be replaced by the file path, %2 by the error message
+        //% "Failed to open OPML file %1: %2"
+        exit(fileError(qtTrId("statalihcmd-err-feeds-import-open-opml").arg(fileName, file.errorString())));
+        return false;
+    }
+
+    QLocale locale;
+    QStringList warnings;
+    QSet<QString> queued;
+
+    // the file is read as a stream, outlines can be nested into categories at any depth
+    QXmlStreamReader xml{&file};
+    while (!xml.atEnd()) {
+        if (xml.readNext() != QXmlStreamReader::StartElement || xml.name() != "outline"_L1) {
+            continue;
+        }
+
+        const QXmlStreamAttributes attrs = xml.attributes();
+        const QString xmlUrl = attrs.value("xmlUrl"_L1).trimmed().toString();
+        if (xmlUrl.isEmpty()) {
+            // category outlines do not have a feed URL
+            continue;
+        }
+
+        const QUrl url{xmlUrl};
+        if (!url.isValid() || (url.scheme() != "http"_L1 && url.scheme() != "https"_L1)) {
+            //: Warning message, %1 will be replaced by the URL
+            //% "Skipping invalid or not supported web feed URL %1."
+            warnings << qtTrId("statalihcmd-warn-feeds-import-invalid-url").arg(locale.quoteString(xmlUrl));
+            continue;
+        }
+
+        const QString source = url.toString();
+        if (m_sources.contains(source)) {
+            ++m_skipped;
+            continue;
+        }
+
+        if (queued.contains(source)) {
+            continue;
+        }
+        queued.insert(source);
+
+        QString title = attrs.value("title"_L1).toString().simplified();
+        if (title.isEmpty()) {
+            title = attrs.value("text"_L1).toString().simplified();
+        }
+
+        m_feedsToImport.enqueue({url, title});
+    }
+
+    if (Q_UNLIKELY(xml.hasError())) {
+        printFailed();
+        //: Error message, %1 and %2 will be replaced by line and column,
+        //: %3 by the error message of the parser
+        //% "Failed to parse OPML data at line %1 and column %2: %3"
+        exit(parsingError(qtTrId("statalihcmd-err-feeds-import-parsing").arg(QString::number(xml.lineNumber()), QString::number(xml.columnNumber()), xml.errorString())));
+        return false;
+    }
+
+    for (const QString &warning : std::as_const(warnings)) {
+        printWarning(warning);
+    }
+
+    return true;
+}
+
+void FeedsImportCommand::importFeed()
+{
+    if (m_feedsToImport.empty() && m_inFlight == 0) {
+        importFinished();
+        return;
+    }
+
+    while (m_inFlight < m_concurrency && !m_feedsToImport.empty()) {
+        const OpmlFeed current = m_feedsToImport.dequeue();
+        ++m_inFlight;
+
+        m_scheduler->get(QNetworkRequest{current.source}, this, [this, current](QNetworkReply *reply){
+            // parse the feed while it is downloaded
+            auto parser = new FeedParser(this);
+            parser->setFallbackSource(current.source);
+            parser->parse(reply);
+            connect(reply, &QNetworkReply::finished, this, [this, current, reply, parser]{
+                feedFetched(current, reply, parser);
+            });
+        });
+    }
+}
+
+void FeedsImportCommand::feedFetched(const OpmlFeed &current, QNetworkReply *reply, FeedParser *parser)
+{
+    reply->deleteLater();
+
+    if (reply->error() != QNetworkReply::NoError) {
+        parser->deleteLater();
+        printFeedFailed(current);
+        // source string defined in feedsupdatecommand.cpp
+        printWarning(qtTrId("statalihcmd-warn-feeds-update-fetch-failed").arg(current.source.toString(), reply->errorString()));
+        feedFailed(RC::NetworkError);
+        feedFinished();
+        return;
+    }
+
+    const QString etag = QString::fromLatin1(reply->rawHeader("ETag"_ba));
+    const QString lastModified = QString::fromLatin1(reply->rawHeader("Last-Modified"_ba));
+
+    connect(parser, &FeedParser::feedParsed, this, [this, current, parser, etag, lastModified](const Feed &feed){
+        if (Q_UNLIKELY(parser->hasError())) {
+            printFeedFailed(current);
+            // source string defined in feedsaddcommand.cpp
+            printWarning(qtTrId("statlihcmd-err-feeds-add-parsing").arg(QString::number(parser->errorLine()), QString::number(parser->errorColumn()), parser->errorString()));
+            feedFailed(RC::ParsingError);
+            feedFinished();
+        } else {
+            feedParsed(current, feed, etag, lastModified, parser->contentHash());
+        }
+    });
+    connect(parser, &FeedParser::feedParsed, parser, &QObject::deleteLater);
+    parser->finish();
+}
+
+void FeedsImportCommand::feedParsed(const OpmlFeed &current, const Feed &feed, const QString &etag, const QString &lastModified, const QByteArray &contentHash)
+{
+    if (Q_UNLIKELY(!feed.isValid())) {
+        printFeedFailed(current);
+        // source string defined in feedsaddcommand.cpp
+        printWarning(qtTrId("statlihcmd-err-feeds-add-invalid-feed"));
+        feedFailed(RC::ParsingError);
+        feedFinished();
+        return;
+    }
+
+    // the feed might declare another source than the URL from the OPML file
+    if (m_sources.contains(feed.source().toString())) {
+        printFeedDone(current);
+        ++m_skipped;
+        feedFinished();
+        return;
+    }
+
+    FeedStore::NewFeed newFeed;
+    newFeed.feed = feed;
+    newFeed.placeId = m_placeId;
+    newFeed.title = feed.title().simplified();
+    if (newFeed.title.isEmpty()) {
+        newFeed.title = current.title;
+    }
+    newFeed.slug = uniqueSlug(newFeed.title.isEmpty() ? current.source.host() : newFeed.title);
+    newFeed.description = Utils::cleanDescription(feed.description());
+    newFeed.etag = etag;
+    newFeed.lastModified = lastModified;
+    newFeed.contentHash = contentHash;
+
+    FeedStore store{HBNST_DBCONNAME};
+    store.loadConfig(this);
+    const auto feedId = store.insert(newFeed);
+    if (Q_UNLIKELY(!feedId)) {
+        printFeedFailed(current);
+        printError(store.lastError().text());
+        feedFailed(RC::DbError);
+        feedFinished();
+        return;
+    }
+
+    m_sources.insert(feed.source().toString());
+
+    if (*feedId == 0) {
+        printFeedDone(current);
+        ++m_skipped;
+        feedFinished();
+        return;
+    }
+
+    ++m_added;
+
+    auto iie = new ItemImageExtractor(m_scheduler, this);
+    iie->loadConfig(this);
+    iie->setCacheConnectionName(HBNST_DBCONNAME);
+    connect(iie, &ItemImageExtractor::finished, this, [this, current, iie, id = *feedId](const QVariantMap &itemImages){
+        ItemStore store{HBNST_DBCONNAME};
+        if (Q_UNLIKELY(!store.addImageStats(id, iie->imagesFromFeed(), iie->pagesScraped()))) {
+            qCWarning(ST_UPDATER).noquote() << "Failed to update image statistics of feed" << id << "in the database:" << store.lastError().text();
+        }
+        imagesFetched(current, itemImages);
+    });
+    iie->start(feed.items());
+}
+
+void FeedsImportCommand::imagesFetched(const OpmlFeed &current, const QVariantMap &itemImages)
+{
+    if (!itemImages.empty()) {
+        auto db = QSqlDatabase::database(HBNST_DBCONNAME);
+        ItemStore store{HBNST_DBCONNAME};
+        if (Q_UNLIKELY(!db.transaction() || !store.setImages(itemImages) || !db.commit())) {
+            const QString error = store.lastError().isValid() ? store.lastError().text() : db.lastError().text();
+            db.rollback();
+            qCWarning(ST_UPDATER).noquote() << "Failed to write item images of feed" << current.source.toString() << "to the database:" << error;
+        }
+    }
+
+    printFeedDone(current);
+    feedFinished();
+}
+
+QString FeedsImportCommand::uniqueSlug(const QString &title)
+{
+    const QString base = Utils::slugify(title);
+    QString slug = base;
+    for (int i = 2; m_slugs.contains(slug); ++i) {
+        slug = base + '-'_L1 + QString::number(i);
+    }
+    m_slugs.insert(slug);
+    return slug;
+}
+
+void FeedsImportCommand::feedFailed(RC rc)
+{
+    ++m_failed;
+    m_failedRc = rc;
+}
+
+void FeedsImportCommand::feedFinished()
+{
+    --m_inFlight;
+    QMetaObject::invokeMethod(this, &FeedsImportCommand::importFeed, Qt::QueuedConnection);
+}
+
+void FeedsImportCommand::importFinished()
+{
+    //: Final message of the import, %1 will be replaced by the number of added feeds,
+    //: %2 by the number of feeds that already exist, %3 by the number of failed feeds
+    //% "Added %1 web feeds, skipped %2 existing web feeds, failed to import %3 web feeds."
+    printMessage(qtTrId("statalihcmd-msg-feeds-import-summary").arg(QString::number(m_added), QString::number(m_skipped), QString::number(m_failed)));
+    // scripts have to be able to detect a partial import, the code is the one of the last failure
+    exit(m_failed > 0 ? m_failedRc : RC::OK);
+}
+
+void FeedsImportCommand::printFeedStatus(const OpmlFeed &current) const
+{
+    //% "Importing feed %1"
+    printStatus(qtTrId("statalihcmd-status-feeds-import-feed").arg(current.source.toString()));
+}
+
+void FeedsImportCommand::printFeedDone(const OpmlFeed &current) const
+{
+    // status and result are printed together to not mix up output of feeds that are imported in parallel
+    printFeedStatus(current);
+    printDone();
+}
+
+void FeedsImportCommand::printFeedFailed(const OpmlFeed &current) const
+{
+    printFeedStatus(current);
+    printFailed();
+}
+
+QString FeedsImportCommand::summary() const
+{
+    //: CLI command summary
+    //% "Import web feeds from OPML"
+    return qtTrId("statalihcmd-command-feeds-import-summary");
+}
+
+QString FeedsImportCommand::description() const
+{
+    //: CLI command description
+    //% "Imports all web feeds listed in an OPML file into a place. The feeds are fetched and parsed in parallel and stored together with their items. Feeds that are already in the database are skipped."
+    return qtTrId("statalihcmd-command-feeds-import-description");
+}
+
+#include "moc_feedsimportcommand.cpp"
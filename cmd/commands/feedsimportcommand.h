@@ -0,0 +1,77 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef HBNST_FEEDSIMPORTCOMMAND_H
+#define HBNST_FEEDSIMPORTCOMMAND_H
+
+#include "command.h"
+#include "feed.h"
+
+#include <QQueue>
+#include <QSet>
+#include <QUrl>
+
+class FeedParser;
+class HostScheduler;
+class QNetworkReply;
+
+/*!
+ * \brief Imports multiple web feeds from an OPML file.
+ *
+ * The feeds are fetched and parsed in parallel, every feed is written
+ * together with its initial items inside its own transaction.
+ */
+class FeedsImportCommand : public Command
+{
+    Q_OBJECT
+public:
+    explicit FeedsImportCommand(QObject *parent = nullptr);
+    ~FeedsImportCommand() override = default;
+
+    void exec(QCommandLineParser *parser) override;
+
+    [[nodiscard]] QString summary() const override;
+
+    [[nodiscard]] QString description() const override;
+
+private slots:
+    void importFeed();
+
+private:
+    struct OpmlFeed {
+        QUrl source;
+        QString title;
+    };
+
+    void init();
+    [[nodiscard]] bool loadExisting();
+    [[nodiscard]] bool readOpml(const QString &fileName);
+    void feedFetched(const OpmlFeed &current, QNetworkReply *reply, FeedParser *parser);
+    void feedParsed(const OpmlFeed &current, const Feed &feed, const QString &etag, const QString &lastModified, const QByteArray &contentHash);
+    void imagesFetched(const OpmlFeed &current, const QVariantMap &itemImages);
+    [[nodiscard]] QString uniqueSlug(const QString &title);
+    void feedFailed(RC rc);
+    void feedFinished();
+    void importFinished();
+    void printFeedStatus(const OpmlFeed &current) const;
+    void printFeedDone(const OpmlFeed &current) const;
+    void printFeedFailed(const OpmlFeed &current) const;
+
+    QQueue<OpmlFeed> m_feedsToImport;
+    QSet<QString> m_sources;
+    QSet<QString> m_slugs;
+    HostScheduler *m_scheduler{nullptr};
+    int m_placeId{0};
+    int m_concurrency{4};
+    int m_inFlight{0};
+    int m_added{0};
+    int m_skipped{0};
+    int m_failed{0};
+    RC m_failedRc{RC::OK};
+
+    Q_DISABLE_COPY(FeedsImportCommand);
+};
+
+#endif // HBNST_FEEDSIMPORTCOMMAND_H
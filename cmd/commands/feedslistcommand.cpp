@@ -4,17 +4,13 @@
  */
 
 #include "feedslistcommand.h"
-#include "utils.h"
+#include "jsonstreamwriter.h"
 
 #include <QCommandLineOption>
 #include <QCommandLineParser>
-#include <QJsonArray>
-#include <QJsonDocument>
-#include <QJsonObject>
 #include <QSqlDatabase>
 #include <QSqlError>
 #include <QSqlQuery>
-#include <QTextStream>
 
 #include <QDebug>
 
@@ -44,7 +40,14 @@ void FeedsListCommand::init()
                               // source string defined in placesaddcommand.cpp
                               qtTrId("statlihcmd-opt-value-dbid"));
 
-    addOutputFormatOption();
+    addPaginationOptions(
+        //: CLI option description
+        //% "Only show feeds with an ID greater than the given ID."
+        qtTrId("statalihcmd-opt-feeds-list-after-desc"),
+        // source string defined in placesaddcommand.cpp
+        qtTrId("statlihcmd-opt-value-dbid"));
+
+    addOutputFormatOption(true);
 }
 
 void FeedsListCommand::exec(QCommandLineParser *parser)
@@ -79,7 +82,25 @@ void FeedsListCommand::exec(QCommandLineParser *parser)
 
     QString search = parser->value(u"search"_s);
 
+    const auto limit = parseLimit(parser);
+    if (!limit) {
+        return;
+    }
+
+    int afterId = 0;
+    if (parser->isSet(u"after"_s)) {
+        bool ok = false;
+        afterId = parser->value(u"after"_s).toInt(&ok);
+        if (!ok || afterId < 1) {
+            printFailed();
+            //% "Invalid ID for --after."
+            exit(inputError(qtTrId("statalihcmd-err-invalid-after-id")));
+            return;
+        }
+    }
+
     const QString outputFormat = parser->value(u"format"_s).toLower();
+    const auto jsonFormat = JsonStreamWriter::formatFromName(outputFormat);
 
     printDone();
 
@@ -93,9 +114,11 @@ void FeedsListCommand::exec(QCommandLineParser *parser)
     printStatus(qtTrId("statalihcmd-status-query-db"));
 
     QSqlQuery q{QSqlDatabase::database(HBNST_DBCONNAME)};
+    // the rows are not cached on the client and are fetched in single row mode by the driver
+    q.setForwardOnly(true);
 
     QString qs;
-    if (outputFormat == "json"_L1 || outputFormat == "json-pretty"_L1) {
+    if (jsonFormat) {
         qs = u"SELECT * FROM feeds"_s;
     } else {
         qs = uR"-(SELECT id, "placeId", slug, title, link, "lastFetch", enabled FROM feeds)-"_s;
@@ -111,11 +134,21 @@ void FeedsListCommand::exec(QCommandLineParser *parser)
         where << uR"-("placeId" = :placeId)-"_s;
     }
 
+    if (afterId > 0) {
+        where << u"id > :afterId"_s;
+    }
+
     if (!where.empty()) {
         qs += " WHERE "_L1;
         qs += where.join(" AND "_L1);
     }
 
+    qs += u" ORDER BY id"_s;
+
+    if (*limit > 0) {
+        qs += u" LIMIT :limit"_s;
+    }
+
     if (Q_UNLIKELY(!q.prepare(qs))) {
         printFailed();
         exit(dbError(q));
@@ -132,6 +165,14 @@ void FeedsListCommand::exec(QCommandLineParser *parser)
         q.bindValue(u":placeId"_s, placeId);
     }
 
+    if (afterId > 0) {
+        q.bindValue(u":afterId"_s, afterId);
+    }
+
+    if (*limit > 0) {
+        q.bindValue(u":limit"_s, *limit);
+    }
+
     if (Q_UNLIKELY(!q.exec())) {
         printFailed();
         exit(dbError(q));
@@ -140,7 +181,8 @@ void FeedsListCommand::exec(QCommandLineParser *parser)
 
     printDone();
 
-    if (q.size() == 0) {
+    // forward only queries have no size, so the first row is fetched to check for an empty result
+    if (!q.next()) {
         //% "Your query has not returned any result."
         printWarning(qtTrId("statlihcmd-warn-feeds-list-nothing-found"));
         exit(RC::OK);
@@ -148,12 +190,10 @@ void FeedsListCommand::exec(QCommandLineParser *parser)
     }
 
 
-    if (outputFormat == "json"_L1 || outputFormat == "json-pretty"_L1) {
+    if (jsonFormat) {
 
-        const auto jsonArray = Utils::queryToJsonObjectArray(q);
-        const QJsonDocument json(jsonArray);
-        QTextStream out(stdout, QIODeviceBase::WriteOnly);
-        out << json.toJson(outputFormat == "json"_L1 ? QJsonDocument::Compact : QJsonDocument::Indented);
+        JsonStreamWriter writer{*jsonFormat};
+        writer.writeQuery(q);
 
     } else {
         const QStringList headers{
@@ -180,9 +220,11 @@ void FeedsListCommand::exec(QCommandLineParser *parser)
 
         QLocale locale;
         QList<QStringList> data;
-        while (q.next()) {
+        int lastId = 0;
+        do {
             QStringList row;
-            row << QString::number(q.value(0).toInt());
+            lastId = q.value(0).toInt();
+            row << QString::number(lastId);
             row << QString::number(q.value(1).toInt());
             row << q.value(2).toString();
             row << q.value(3).toString();
@@ -203,9 +245,14 @@ void FeedsListCommand::exec(QCommandLineParser *parser)
             row << isEnabled;
 
             data << row;
-        }
+        } while (q.next());
 
         printTable(headers, data);
+
+        if (*limit > 0 && data.size() == *limit) {
+            // source string defined in feedslistitemscommand.cpp
+            printMessage(qtTrId("statalihcmd-msg-feeds-listitems-next-page").arg(lastId));
+        }
     }
 
     exit(RC::OK);
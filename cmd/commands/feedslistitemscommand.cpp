@@ -4,17 +4,14 @@
  */
 
 #include "feedslistitemscommand.h"
-#include "utils.h"
+#include "keysetcursor.h"
+#include "jsonstreamwriter.h"
 
 #include <QCommandLineOption>
 #include <QCommandLineParser>
-#include <QJsonArray>
-#include <QJsonDocument>
-#include <QJsonObject>
 #include <QSqlDatabase>
 #include <QSqlError>
 #include <QSqlQuery>
-#include <QTextStream>
 
 using namespace Qt::StringLiterals;
 
@@ -44,12 +41,20 @@ void FeedsListItemsCommand::init()
 
     m_cliOptions.emplaceBack(QStringList({u"s"_s, u"search"_s}),
                              //: CLI option description
-                             //% "Search for text in item title or description."
+                             //% "Search for text in item title or description. Supports the web search syntax with quotes, or and -."
                              qtTrId("statalihcmd-opt-feeds-itemlist-search-desc"),
                              // source string defined in feedsaddcommand.cpp
                              qtTrId("statalihcmd-opt-value-text"));
 
-    addOutputFormatOption();
+    addPaginationOptions(
+        //: CLI option description
+        //% "Only show items after the position printed at the end of the previous page. Can not be used together with --search."
+        qtTrId("statalihcmd-opt-feeds-itemlist-after-desc"),
+        //: CLI option value name
+        //% "position"
+        qtTrId("statalihcmd-opt-value-position"));
+
+    addOutputFormatOption(true);
 }
 
 void FeedsListItemsCommand::exec(QCommandLineParser *parser)
@@ -104,7 +109,30 @@ void FeedsListItemsCommand::exec(QCommandLineParser *parser)
 
     QString search = parser->value(u"search"_s);
 
+    const auto limit = parseLimit(parser);
+    if (!limit) {
+        return;
+    }
+
+    std::optional<KeysetCursor> after;
+    if (parser->isSet(u"after"_s)) {
+        if (!search.isEmpty()) {
+            printFailed();
+            //% "Either --search or --after is supported but not both."
+            exit(inputError(qtTrId("statalihcmd-err-feeds-listitems-searchandafter")));
+            return;
+        }
+        after = KeysetCursor::fromString(parser->value(u"after"_s));
+        if (!after) {
+            printFailed();
+            //% "Invalid position for --after."
+            exit(inputError(qtTrId("statalihcmd-err-feeds-listitems-invalid-after")));
+            return;
+        }
+    }
+
     const QString outputFormat = parser->value(u"format"_s).toLower();
+    const auto jsonFormat = JsonStreamWriter::formatFromName(outputFormat);
 
     printDone();
 
@@ -118,18 +146,29 @@ void FeedsListItemsCommand::exec(QCommandLineParser *parser)
     printStatus(qtTrId("statalihcmd-status-query-db"));
 
     QSqlQuery q{QSqlDatabase::database(HBNST_DBCONNAME)};
+    // the rows are not cached on the client and are fetched in single row mode by the driver
+    q.setForwardOnly(true);
 
     QString qs;
-    if (outputFormat == "json"_L1 || outputFormat == "json-pretty"_L1) {
-        qs = uR"-(SELECT i.id, i."feedId", p.id AS "placeId", i.guid, i.title, i.description, i.author, i."pubDate", i.link, i.data FROM items i JOIN feeds f ON i."feedId" = f.id JOIN places p ON f."placeId" = p.id)-"_s;
+    if (!search.isEmpty()) {
+        // feeds may use different text search configurations, so the query is
+        // combined from the query of every configuration that is in use
+        qs = uR"-(WITH tsq AS MATERIALIZED (
+                    SELECT string_agg('(' || websearch_to_tsquery(c, :search)::text || ')', ' | ')::tsquery AS q
+                    FROM (SELECT DISTINCT "searchConfig" AS c FROM feeds) cfgs
+                    WHERE numnode(websearch_to_tsquery(c, :search)) > 0) )-"_s;
+    }
+    if (jsonFormat) {
+        qs += uR"-(SELECT i.id, i."feedId", p.id AS "placeId", i.guid, i.title, i.description, i.author, i."pubDate", i.link, i.data FROM items i JOIN feeds f ON i."feedId" = f.id JOIN places p ON f."placeId" = p.id)-"_s;
     } else {
-        qs = uR"-(SELECT i.id, i."feedId", p.id AS "placeId", i.title, i."pubDate", i.link FROM items i JOIN feeds f ON i."feedId" = f.id JOIN places p ON f."placeId" = p.id)-"_s;
+        qs += uR"-(SELECT i.id, i."feedId", p.id AS "placeId", i.title, i."pubDate", i.link FROM items i JOIN feeds f ON i."feedId" = f.id JOIN places p ON f."placeId" = p.id)-"_s;
     }
 
     QStringList where;
 
     if (!search.isEmpty()) {
-        where << u"(i.title ILIKE :search OR i.description ILIKE :search)"_s;
+        // the trigram index on the title is used for substring matches
+        where << u"(i.search @@ (SELECT q FROM tsq) OR i.title ILIKE :searchLike)"_s;
     }
 
     if (placeId > -1) {
@@ -140,12 +179,24 @@ void FeedsListItemsCommand::exec(QCommandLineParser *parser)
         where << uR"-(i."feedId" = :feedId)-"_s;
     }
 
+    if (after) {
+        where << after->condition(uR"-(i."pubDate")-"_s, u"i.id"_s, u":afterDate"_s, u":afterId"_s);
+    }
+
     if (!where.empty()) {
         qs += " WHERE "_L1;
         qs += where.join(" AND "_L1);
     }
 
-    qs += uR"-( ORDER BY i."pubDate" DESC)-"_s;
+    if (!search.isEmpty()) {
+        qs += uR"-( ORDER BY ts_rank(i.search, (SELECT q FROM tsq)) DESC NULLS LAST, i."pubDate" DESC)-"_s;
+    } else {
+        qs += uR"-( ORDER BY i."pubDate" DESC, i.id DESC)-"_s;
+    }
+
+    if (*limit > 0) {
+        qs += u" LIMIT :limit"_s;
+    }
 
     if (Q_UNLIKELY(!q.prepare(qs))) {
         printFailed();
@@ -154,9 +205,11 @@ void FeedsListItemsCommand::exec(QCommandLineParser *parser)
     }
 
     if (!search.isEmpty()) {
+        q.bindValue(u":search"_s, search);
+        search.replace('\\'_L1, "\\\\"_L1).replace('%'_L1, "\\%"_L1).replace('_'_L1, "\\_"_L1);
         search.prepend('%'_L1);
         search.append('%'_L1);
-        q.bindValue(u":search"_s, search);
+        q.bindValue(u":searchLike"_s, search);
     }
 
     if (placeId > -1) {
@@ -167,6 +220,17 @@ void FeedsListItemsCommand::exec(QCommandLineParser *parser)
         q.bindValue(u":feedId"_s, feedId);
     }
 
+    if (after) {
+        if (after->date.isValid()) {
+            q.bindValue(u":afterDate"_s, after->date);
+        }
+        q.bindValue(u":afterId"_s, after->id);
+    }
+
+    if (*limit > 0) {
+        q.bindValue(u":limit"_s, *limit);
+    }
+
     if (Q_UNLIKELY(!q.exec())) {
         printFailed();
         exit(dbError(q));
@@ -175,19 +239,18 @@ void FeedsListItemsCommand::exec(QCommandLineParser *parser)
 
     printDone();
 
-    if (q.size() == 0) {
+    // forward only queries have no size, so the first row is fetched to check for an empty result
+    if (!q.next()) {
         // source string defined in feedslistcommand.cpp
         printWarning(qtTrId("statlihcmd-warn-feeds-list-nothing-found"));
         exit(RC::OK);
         return;
     }
 
-    if (outputFormat == "json"_L1 || outputFormat == "json-pretty"_L1) {
+    if (jsonFormat) {
 
-        const auto jsonArray = Utils::queryToJsonObjectArray(q);
-        const QJsonDocument json{jsonArray};
-        QTextStream out(stdout, QIODeviceBase::WriteOnly);
-        out << json.toJson(outputFormat == "json"_L1 ? QJsonDocument::Compact : QJsonDocument::Indented);
+        JsonStreamWriter writer{*jsonFormat};
+        writer.writeQuery(q);
 
     } else {
         const QStringList headers{
@@ -209,9 +272,12 @@ void FeedsListItemsCommand::exec(QCommandLineParser *parser)
 
         QLocale locale;
         QList<QStringList> data;
-        while (q.next()) {
+        KeysetCursor last;
+        do {
             QStringList row;
-            row << QString::number(q.value(0).toLongLong());
+            last.id = q.value(0).toLongLong();
+            last.date = q.value(4).toDateTime();
+            row << QString::number(last.id);
             row << QString::number(q.value(1).toInt());
             row << QString::number(q.value(2).toInt());
             row << q.value(3).toString();
@@ -224,9 +290,14 @@ void FeedsListItemsCommand::exec(QCommandLineParser *parser)
             row << q.value(5).toString();
 
             data << row;
-        }
+        } while (q.next());
 
         printTable(headers, data);
+
+        if (search.isEmpty() && *limit > 0 && data.size() == *limit) {
+            //% "Use --after %1 to show the next page."
+            printMessage(qtTrId("statalihcmd-msg-feeds-listitems-next-page").arg(last.toString()));
+        }
     }
 
     exit(RC::OK);
@@ -5,18 +5,16 @@
 
 #include "feedsupdatecommand.h"
 #include "feedparser.h"
+#include "hostscheduler.h"
 #include "itemimageextractor.h"
+#include "itemstore.h"
 #include "utils.h"
 
 #include <QCommandLineOption>
 #include <QCommandLineParser>
-#include <QDomDocument>
-#include <QJsonDocument>
-#include <QJsonObject>
 #include <QLocale>
 #include <QLoggingCategory>
 #include <QMetaObject>
-#include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QNetworkRequest>
 #include <QSqlDatabase>
@@ -68,6 +66,39 @@ void FeedsUpdateCommand::init()
                               qtTrId("statalihcmd-opt-feeds-update-id-desc"),
                               // source string defined in placesaddcommand.cpp
                               qtTrId("statlihcmd-opt-value-dbid"));
+
+    m_cliOptions.emplace_back(QStringList({u"due"_s}),
+                              //: CLI option description
+                              //% "Only update feeds whose next fetch time has been reached. Updates all due feeds if used without other selection."
+                              qtTrId("statalihcmd-opt-feeds-update-due-desc"));
+
+    addConcurrencyOption();
+}
+
+void FeedsUpdateCommand::addConcurrencyOption()
+{
+    m_cliOptions.emplace_back(QStringList({u"c"_s, u"concurrency"_s}),
+                              //: CLI option description
+                              //% "Number of feeds that will be fetched in parallel. Default: 1."
+                              qtTrId("statalihcmd-opt-feeds-update-concurrency-desc"),
+                              //: CLI option value name
+                              //% "number"
+                              qtTrId("statalihcmd-opt-value-number"),
+                              u"1"_s);
+}
+
+bool FeedsUpdateCommand::parseConcurrency(QCommandLineParser *parser)
+{
+    bool concurrencyOk = false;
+    m_concurrency = parser->value(u"concurrency"_s).toInt(&concurrencyOk);
+    if (!concurrencyOk || m_concurrency < 1) {
+        printFailed();
+        qCCritical(ST_UPDATER) << "Invalid concurrency value.";
+        //% "Invalid concurrency value. Has to be a number greater than 0."
+        exit(inputError(qtTrId("statalihcmd-err-feeds-update-invalid-concurrency")));
+        return false;
+    }
+    return true;
 }
 
 void FeedsUpdateCommand::exec(QCommandLineParser *parser)
@@ -89,10 +120,10 @@ void FeedsUpdateCommand::exec(QCommandLineParser *parser)
     // source string defined in feedsaddcommand.cpp
     printStatus(qtTrId("statalihcmd-status-parsing-input"));
 
-    if (!parser->isSet(u"a"_s) && !parser->isSet(u"p"_s) && !parser->isSet(u"s"_s) && !parser->isSet(u"id"_s)) {
+    if (!parser->isSet(u"a"_s) && !parser->isSet(u"p"_s) && !parser->isSet(u"s"_s) && !parser->isSet(u"id"_s) && !parser->isSet(u"due"_s)) {
         printFailed();
         qCCritical(ST_UPDATER) << "No feed selected for update.";
-        const QStringList opts{u"--all"_s, u"--place"_s, u"--slug"_s, u"--id"_s};
+        const QStringList opts{u"--all"_s, u"--place"_s, u"--slug"_s, u"--id"_s, u"--due"_s};
         //% "Use one of %1 to select the feeds you want to update."
         exit(inputError(qtTrId("statalihcmd-err-feeds-update-invalid-feed-selection").arg(locale.createSeparatedList(opts))));
         return;
@@ -122,6 +153,10 @@ void FeedsUpdateCommand::exec(QCommandLineParser *parser)
         }
     }
 
+    if (!parseConcurrency(parser)) {
+        return;
+    }
+
     printDone();
 
     CLI::RC rc = openDb(HBNST_DBCONNAME);
@@ -134,14 +169,18 @@ void FeedsUpdateCommand::exec(QCommandLineParser *parser)
     //% "Query feeds to update from database"
     printStatus(qtTrId("statalihcmd-status-feeds-update-query-feeds-db"));
 
-    QString qs = uR"-(SELECT f.id, f.title, f.source, f."lastBuildDate", f."lastFetch" FROM feeds f)-"_s;
+    QString qs = u"SELECT "_s + feedColumns() + u" FROM feeds f"_s;
 
-    if (!parser->isSet(u"all"_s) && !parser->isSet(u"id"_s)) {
+    if (!parser->isSet(u"all"_s) && !parser->isSet(u"id"_s) && (parser->isSet(u"p"_s) || parser->isSet(u"s"_s))) {
         qs += uR"-( JOIN places p ON p.id = f."placeId")-"_s;
     }
 
     qs += uR"-( WHERE f.enabled = true)-"_s;
 
+    if (parser->isSet(u"due"_s)) {
+        qs += uR"-( AND (f."nextFetch" IS NULL OR f."nextFetch" <= :now))-"_s;
+    }
+
     if (!parser->isSet(u"all"_s)) {
         if (parser->isSet(u"id"_s)) {
             qs += u" AND f.id = :id";
@@ -167,10 +206,14 @@ void FeedsUpdateCommand::exec(QCommandLineParser *parser)
         } else if (parser->isSet(u"p"_s)) {
             q.bindValue(u":id"_s, parser->value(u"place"_s).toInt());
         } else if (parser->isSet(u"s"_s)) {
-            q.bindValue(u":slug"_s, parser->value(u"slug"_s).toInt());
+            q.bindValue(u":slug"_s, parser->value(u"slug"_s));
         }
     }
 
+    if (parser->isSet(u"due"_s)) {
+        q.bindValue(u":now"_s, QDateTime::currentDateTimeUtc());
+    }
+
     if (Q_UNLIKELY(!q.exec())) {
         printFailed();
         qCCritical(ST_UPDATER) << "Failed to execute query to get feeds to update from database:" << q.lastError().text();
@@ -181,13 +224,7 @@ void FeedsUpdateCommand::exec(QCommandLineParser *parser)
     printDone();
 
     while (q.next()) {
-        m_feedsToUpdate.enqueue({
-                                    q.value(0).toInt(),
-                                    q.value(1).toString(),
-                                    QUrl(q.value(2).toString()),
-                                    q.value(3).toDateTime(),
-                                    q.value(4).toDateTime()
-                                });
+        m_feedsToUpdate.enqueue(feedFromQuery(q));
     }
 
     if (m_feedsToUpdate.isEmpty()) {
@@ -198,292 +235,374 @@ void FeedsUpdateCommand::exec(QCommandLineParser *parser)
         return;
     }
 
-    qCInfo(ST_UPDATER) << "Start updating" << m_feedsToUpdate.size() << "feeds";
+    startUpdates();
+}
+
+QString FeedsUpdateCommand::feedColumns()
+{
+    return uR"-(f.id, f.title, f.source, f."lastBuildDate", f."lastFetch", f.etag, f."lastModified", f."contentHash", f."nextFetch")-"_s;
+}
+
+FeedsUpdateCommand::FeedStruct FeedsUpdateCommand::feedFromQuery(const QSqlQuery &q)
+{
+    return {
+        q.value(0).toInt(),
+        q.value(1).toString(),
+        QUrl(q.value(2).toString()),
+        q.value(3).toDateTime(),
+        q.value(4).toDateTime(),
+        q.value(5).toString(),
+        q.value(6).toString(),
+        q.value(7).toByteArray(),
+        q.value(8).toDateTime()
+    };
+}
+
+void FeedsUpdateCommand::startUpdates()
+{
+    qCInfo(ST_UPDATER) << "Start updating" << m_feedsToUpdate.size() << "feeds with a concurrency of" << m_concurrency;
+
+    if (!m_scheduler) {
+        m_scheduler = new HostScheduler(this);
+        m_scheduler->loadConfig(this);
+        m_schedule.loadConfig(this);
+    }
 
-    m_nam = new QNetworkAccessManager(this);
-    m_nam->setTransferTimeout(10'000);
-    connect(m_nam, &QNetworkAccessManager::finished, this, &FeedsUpdateCommand::feedFetched);
+    QMetaObject::invokeMethod(this, &FeedsUpdateCommand::updateFeed, Qt::QueuedConnection);
+}
 
-    QMetaObject::invokeMethod(this, &FeedsUpdateCommand::updateFeed);
+void FeedsUpdateCommand::updatesFinished()
+{
+    qCInfo(ST_UPDATER) << "Finished updating feeds";
+    exit(RC::OK);
 }
 
 void FeedsUpdateCommand::updateFeed()
 {
-    if (m_feedsToUpdate.empty()) {
-        qCInfo(ST_UPDATER) << "Finished updating feeds";
-        exit(RC::OK);
+    if (m_feedsToUpdate.empty() && m_inFlight == 0) {
+        updatesFinished();
+        return;
+    }
+
+    // Every fetch carries its own copy of the feed context, so the replies can finish in any order.
+    // Database writes are still serialized because all of them run synchronously in the event loop thread.
+    while (m_inFlight < m_concurrency && !m_feedsToUpdate.empty()) {
+        const FeedStruct current = m_feedsToUpdate.dequeue();
+        ++m_inFlight;
+
+        qCInfo(ST_UPDATER).noquote() << "Start updating feed" << current.logInfo();
+
+        QNetworkRequest req{current.source};
+        // send the validators of the last response back verbatim, servers compare them byte by byte
+        if (!current.etag.isEmpty()) {
+            req.setRawHeader("If-None-Match"_ba, current.etag.toLatin1());
+        }
+        if (!current.lastModified.isEmpty()) {
+            req.setRawHeader("If-Modified-Since"_ba, current.lastModified.toLatin1());
+        } else if (current.lastBuildDate.isValid()) {
+            req.setHeader(QNetworkRequest::IfModifiedSinceHeader, current.lastBuildDate);
+        }
+        qCInfo(ST_UPDATER).noquote() << "Fetching feed" << current.logInfo() << "from" << current.source.toString();
+        m_scheduler->get(req, this, [this, current](QNetworkReply *reply){
+            // parse the feed while it is downloaded
+            auto parser = new FeedParser(this);
+            parser->setFallbackSource(current.source);
+            parser->parse(reply);
+            connect(reply, &QNetworkReply::finished, this, [this, current, reply, parser]{
+                feedFetched(current, reply, parser);
+            });
+        });
+    }
+}
+
+QDateTime FeedsUpdateCommand::calculateNextFetch(const FeedStruct &current, const Feed &feed) const
+{
+    QList<QDateTime> pubDates;
+
+    const QList<FeedItem> items = feed.items();
+    pubDates.reserve(items.size() + 20);
+    for (const FeedItem &item : items) {
+        pubDates << item.pubDate();
+    }
+
+    QSqlQuery q{QSqlDatabase::database(HBNST_DBCONNAME)};
+    if (Q_LIKELY(q.prepare(uR"-(SELECT "pubDate" FROM items WHERE "feedId" = :feedId AND "pubDate" IS NOT NULL ORDER BY "pubDate" DESC LIMIT 20)-"_s))) {
+        q.bindValue(u":feedId"_s, current.id);
+        if (Q_LIKELY(q.exec())) {
+            while (q.next()) {
+                pubDates << q.value(0).toDateTime().toUTC();
+            }
+        } else {
+            qCWarning(ST_UPDATER).noquote() << "Failed to execute query to get publication dates of feed" << current.logInfo()
+                                            << "from the database:" << q.lastError().text();
+        }
+    } else {
+        qCWarning(ST_UPDATER).noquote() << "Failed to prepare query to get publication dates of feed" << current.logInfo()
+                                        << "from the database:" << q.lastError().text();
+    }
+
+    const QDateTime nextFetch = m_schedule.nextFetch(QDateTime::currentDateTimeUtc(), pubDates, feed);
+    qCDebug(ST_UPDATER).noquote() << "Next fetch of feed" << current.logInfo() << "at" << nextFetch.toString(Qt::ISODate);
+    return nextFetch;
+}
+
+void FeedsUpdateCommand::feedUnchanged(const FeedStruct &current, const FetchInfo &fetchInfo, const Feed &feed)
+{
+    const QDateTime nextFetch = calculateNextFetch(current, feed);
+
+    QSqlQuery q{QSqlDatabase::database(HBNST_DBCONNAME)};
+
+    if (Q_UNLIKELY(!q.prepare(uR"-(UPDATE feeds SET "lastFetch" = :lastFetch, "nextFetch" = :nextFetch, etag = :etag, "lastModified" = :lastModified, "contentHash" = :contentHash WHERE id = :id)-"_s))) {
+        printFeedFailed(current);
+        qCCritical(ST_UPDATER).noquote() << "Failed to prepare query to update fetch time of feed" << current.logInfo()
+                                         << "in the database:" << q.lastError().text();
+        exit(dbError(q));
+        return;
+    }
+
+    q.bindValue(u":lastFetch"_s, QDateTime::currentDateTimeUtc());
+    q.bindValue(u":nextFetch"_s, nextFetch);
+    q.bindValue(u":etag"_s, fetchInfo.etag.isEmpty() ? QVariant() : fetchInfo.etag);
+    q.bindValue(u":lastModified"_s, fetchInfo.lastModified.isEmpty() ? QVariant() : fetchInfo.lastModified);
+    q.bindValue(u":contentHash"_s, fetchInfo.contentHash.isEmpty() ? QVariant() : fetchInfo.contentHash);
+    q.bindValue(u":id"_s, current.id);
+
+    if (Q_UNLIKELY(!q.exec())) {
+        const QString error = q.lastError().text();
+        printFeedFailed(current);
+        qCWarning(ST_UPDATER).noquote() << "Failed to execute query to update fetch time of feed" << current.logInfo()
+                                        << "in the database:" << error;
+        //% "Failed to update feed in the database: %1"
+        printWarning(qtTrId("statalihcmd-warn-feeds-update-feed-failed").arg(error));
+        feedFailed(current);
+        feedFinished();
         return;
     }
 
-    m_current = m_feedsToUpdate.dequeue();
-    qCInfo(ST_UPDATER).noquote() << "Start updating feed" << m_current.logInfo();
+    printFeedDone(current);
+    //% "Feed has not been modified since last update."
+    printMessage(qtTrId("statlihcmd-info-feeds-update-not-modified"));
+    feedFinished();
+}
 
+void FeedsUpdateCommand::feedFailed(const FeedStruct &current)
+{
+    Q_UNUSED(current)
+}
+
+void FeedsUpdateCommand::feedFinished()
+{
+    --m_inFlight;
+    QMetaObject::invokeMethod(this, &FeedsUpdateCommand::updateFeed, Qt::QueuedConnection);
+}
+
+void FeedsUpdateCommand::printFeedStatus(const FeedStruct &current) const
+{
     QLocale locale;
     //% "Fetching feed %1 (ID: %2)"
-    printStatus(qtTrId("statalihcmd-status-feeds-update-fetching-feed").arg(locale.quoteString(m_current.title), QString::number(m_current.id)));
+    printStatus(qtTrId("statalihcmd-status-feeds-update-fetching-feed").arg(locale.quoteString(current.title), QString::number(current.id)));
+}
 
-    QNetworkRequest req{m_current.source};
-    if (m_current.lastBuildDate.isValid()) {
-        req.setHeader(QNetworkRequest::IfModifiedSinceHeader, m_current.lastBuildDate);
-    }
-    qCInfo(ST_UPDATER).noquote() << "Fetching feed" << m_current.logInfo() << "from" << m_current.source.toString();
-    m_nam->get(req);
+void FeedsUpdateCommand::printFeedDone(const FeedStruct &current) const
+{
+    // status and result are printed together to not mix up output of feeds that are updated in parallel
+    printFeedStatus(current);
+    printDone();
 }
 
-void FeedsUpdateCommand::feedFetched(QNetworkReply *reply)
+void FeedsUpdateCommand::printFeedFailed(const FeedStruct &current) const
 {
+    printFeedStatus(current);
+    printFailed();
+}
+
+void FeedsUpdateCommand::feedFetched(const FeedStruct &current, QNetworkReply *reply, FeedParser *parser)
+{
+    reply->deleteLater();
+
     if (reply->error() != QNetworkReply::NoError) {
-        printFailed();
-        qCWarning(ST_UPDATER).noquote().nospace() << "Failed to fetch feed " << m_current.logInfo() << " from "
-                                                  << m_current.source.toString() << ": " << reply->errorString();
+        parser->deleteLater();
+        printFeedFailed(current);
+        qCWarning(ST_UPDATER).noquote().nospace() << "Failed to fetch feed " << current.logInfo() << " from "
+                                                  << current.source.toString() << ": " << reply->errorString();
         //% "Failed to fetch feed from %1: %2"
-        printWarning(qtTrId("statalihcmd-warn-feeds-update-fetch-failed").arg(m_current.source.toString(), reply->errorString()));
-        updateFeed();
+        printWarning(qtTrId("statalihcmd-warn-feeds-update-fetch-failed").arg(current.source.toString(), reply->errorString()));
+        feedFailed(current);
+        feedFinished();
     } else {
         const auto statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
         if (statusCode == 304) {
-            printDone();
-            qCInfo(ST_UPDATER).noquote() << "Feed" << m_current.logInfo() << "has not been modified since last update.";
-            //% "Feed has not been modified since last update."
-            printMessage(qtTrId("statlihcmd-info-feeds-update-not-modified"));
-            updateFeed();
+            parser->deleteLater();
+            qCInfo(ST_UPDATER).noquote() << "Feed" << current.logInfo() << "has not been modified since last update.";
+            feedUnchanged(current, {current.etag, current.lastModified, current.contentHash});
         } else {
-            QDomDocument doc;
-
-#if QT_VERSION >= QT_VERSION_CHECK(6,5,0)
-            auto parseResult = doc.setContent(reply, QDomDocument::ParseOption::UseNamespaceProcessing);
-            if (Q_UNLIKELY(!parseResult)) {
-                printFailed();
-                qCWarning(ST_UPDATER).noquote().nospace() << "Failed to parse XML of feed " << m_current.logInfo()
-                                                          << " at line " << parseResult.errorLine << " and column "
-                                                          << parseResult.errorColumn << ": " << parseResult.errorMessage;
-                // source string defined in feedsaddcommand.cpp
-                printWarning(qtTrId("statlihcmd-err-feeds-add-parsing").arg(QString::number(parseResult.errorLine), QString::number(parseResult.errorColumn), parseResult.errorMessage));
-                QMetaObject::invokeMethod(this, "updateFeed");
-                return;
-            }
-#else
-            QString errorMsg;
-            int errorLine{-1};
-            int errorColumn{-1};
-            if (Q_UNLIKELY(!doc.setContent(reply, true, &errorMsg, &errorLine, &errorColumn))) {
-                printFailed();
-                qCWarning(ST_UPDATER).noquote().nospace() << "Failed to parse XML of feed " << m_current.logInfo()
-                                                          << " at line " << errorLine << " and column "
-                                                          << errorColumn << ": " << errorMsg;
-                // source string defined in feedsaddcommand.cpp
-                printWarning(qtTrId("statlihcmd-err-feeds-add-parsing").arg(QString::number(errorLine), QString::number(errorColumn), errorMsg));
-                QMetaObject::invokeMethod(this, "updateFeed");
-                return;
-            }
-#endif
-
-            qCInfo(ST_UPDATER).noquote() << "Successfully fetched feed" << m_current.logInfo()
-                                         << "from" << m_current.source.toString();
-            qCInfo(ST_UPDATER).noquote() << "Start parsing feed" << m_current.logInfo();
-
-            auto parser = new FeedParser(this);
-            connect(parser, &FeedParser::feedParsed, this, &FeedsUpdateCommand::feedParsed);
+            qCInfo(ST_UPDATER).noquote() << "Successfully fetched feed" << current.logInfo()
+                                         << "from" << current.source.toString();
+
+            const QString etag = QString::fromLatin1(reply->rawHeader("ETag"_ba));
+            const QString lastModified = QString::fromLatin1(reply->rawHeader("Last-Modified"_ba));
+
+            connect(parser, &FeedParser::feedParsed, this, [this, current, parser, etag, lastModified](const Feed &feed){
+                const FetchInfo fetchInfo{etag, lastModified, parser->contentHash()};
+                // the hash is only stored for bodies whose items have been written, so a match means
+                // that there is nothing new to write, even if the feed has no lastBuildDate
+                if (!current.contentHash.isEmpty() && fetchInfo.contentHash == current.contentHash) {
+                    qCInfo(ST_UPDATER).noquote() << "Content of feed" << current.logInfo() << "is byte-identical to the last update.";
+                    feedUnchanged(current, fetchInfo, feed);
+                } else if (Q_UNLIKELY(parser->hasError())) {
+                    printFeedFailed(current);
+                    qCWarning(ST_UPDATER).noquote().nospace() << "Failed to parse XML of feed " << current.logInfo()
+                                                              << " at line " << parser->errorLine() << " and column "
+                                                              << parser->errorColumn() << ": " << parser->errorString();
+                    // source string defined in feedsaddcommand.cpp
+                    printWarning(qtTrId("statlihcmd-err-feeds-add-parsing").arg(QString::number(parser->errorLine()), QString::number(parser->errorColumn()), parser->errorString()));
+                    feedFailed(current);
+                    feedFinished();
+                } else {
+                    feedParsed(current, feed, fetchInfo);
+                }
+            });
             connect(parser, &FeedParser::feedParsed, parser, &QObject::deleteLater);
-            parser->parse(doc);
+            parser->finish();
         }
     }
 }
 
-void FeedsUpdateCommand::feedParsed(const Feed &feed)
+void FeedsUpdateCommand::feedParsed(const FeedStruct &current, const Feed &feed, const FetchInfo &fetchInfo)
 {
-    m_feed = feed;
     if (!feed.isValid()) {
-        printFailed();
-        qCWarning(ST_UPDATER).noquote() << "Failed to parse feed" << m_current.logInfo();
+        printFeedFailed(current);
+        qCWarning(ST_UPDATER).noquote() << "Failed to parse feed" << current.logInfo();
         //% "Failed to parse feed."
         printWarning(qtTrId("statalihcmd-warn-feeds-update-parsing-failed"));
-        QMetaObject::invokeMethod(this, "updateFeed");
+        feedFailed(current);
+        feedFinished();
         return;
     }
 
-    qCInfo(ST_UPDATER).noquote() << "Successfully parsed feed" << m_current.logInfo();
+    qCInfo(ST_UPDATER).noquote() << "Successfully parsed feed" << current.logInfo();
 
-    if (m_feed.lastBuildDate() == m_current.lastBuildDate) {
-        printDone();
-        qCInfo(ST_UPDATER).noquote() << "Feed" << m_current.logInfo() << "has not been modified since last update.";
-        printMessage(qtTrId("statlihcmd-info-feeds-update-not-modified"));
-        QMetaObject::invokeMethod(this, "updateFeed");
+    if (feed.lastBuildDate().isValid() && feed.lastBuildDate() == current.lastBuildDate) {
+        qCInfo(ST_UPDATER).noquote() << "Feed" << current.logInfo() << "has not been modified since last update.";
+        // the items of this body have not been written, so the hash of the last written body is kept
+        feedUnchanged(current, {fetchInfo.etag, fetchInfo.lastModified, current.contentHash}, feed);
         return;
     }
 
-    qCInfo(ST_UPDATER).noquote() << "Start updating feed" << m_current.logInfo() << "in the database.";
+    qCInfo(ST_UPDATER).noquote() << "Start updating feed" << current.logInfo() << "in the database.";
 
-    QSqlQuery q{QSqlDatabase::database(HBNST_DBCONNAME)};
+    auto db = QSqlDatabase::database(HBNST_DBCONNAME);
 
-    if (Q_UNLIKELY(!q.prepare(uR"-(UPDATE feeds SET "lastBuildDate" = :lastBuildDate, "lastFetch" = :lastFetch WHERE id = :id)-"_s))) {
-        printFailed();
-        qCCritical(ST_UPDATER).noquote() << "Failed to prepare query to update feed" << m_current.logInfo()
+    if (Q_UNLIKELY(!db.transaction())) {
+        printFeedFailed(current);
+        qCCritical(ST_UPDATER).noquote() << "Failed to start transaction to update feed" << current.logInfo()
+                                         << "in the database:" << db.lastError().text();
+        exit(dbError(db));
+        return;
+    }
+
+    const QDateTime nextFetch = calculateNextFetch(current, feed);
+
+    QSqlQuery q{db};
+
+    if (Q_UNLIKELY(!q.prepare(uR"-(UPDATE feeds SET "lastBuildDate" = :lastBuildDate, "lastFetch" = :lastFetch, "nextFetch" = :nextFetch, etag = :etag, "lastModified" = :lastModified, "contentHash" = :contentHash WHERE id = :id)-"_s))) {
+        printFeedFailed(current);
+        qCCritical(ST_UPDATER).noquote() << "Failed to prepare query to update feed" << current.logInfo()
                                          << "in the database:" << q.lastError().text();
+        db.rollback();
         exit(dbError(q));
         return;
     }
 
-    q.bindValue(u":lastBuildDate"_s, m_feed.lastBuildDate());
+    q.bindValue(u":lastBuildDate"_s, feed.lastBuildDate());
     q.bindValue(u":lastFetch"_s, QDateTime::currentDateTimeUtc());
-    q.bindValue(u":id"_s, m_current.id);
+    q.bindValue(u":nextFetch"_s, nextFetch);
+    q.bindValue(u":etag"_s, fetchInfo.etag.isEmpty() ? QVariant() : fetchInfo.etag);
+    q.bindValue(u":lastModified"_s, fetchInfo.lastModified.isEmpty() ? QVariant() : fetchInfo.lastModified);
+    q.bindValue(u":contentHash"_s, fetchInfo.contentHash);
+    q.bindValue(u":id"_s, current.id);
 
     if (Q_UNLIKELY(!q.exec())) {
-        printFailed();
-        qCCritical(ST_UPDATER).noquote() << "Failed to execute query to update feed" << m_current.logInfo()
-                                         << "in the database:" << q.lastError().text();
-        exit(dbError(q));
+        const QString error = q.lastError().text();
+        db.rollback();
+        printFeedFailed(current);
+        qCWarning(ST_UPDATER).noquote() << "Failed to execute query to update feed" << current.logInfo()
+                                        << "in the database:" << error;
+        printWarning(qtTrId("statalihcmd-warn-feeds-update-feed-failed").arg(error));
+        feedFailed(current);
+        feedFinished();
         return;
     }
 
     QList<FeedItem> newItems;
     QList<FeedItem> updatedItems;
 
-    const QList<FeedItem> items = m_feed.items();
-    for (const auto &item : items) {
-
-        if (Q_LIKELY(q.prepare(uR"-(SELECT "pubDate" FROM items WHERE guid = :guid)-"_s))) {
-            q.bindValue(u":guid"_s, item.guid());
-            if (Q_LIKELY(q.exec())) {
-                if (q.next()) {
-                    if (item.pubDate() > q.value(0).toDateTime()) {
-                        qCDebug(ST_UPDATER).noquote().nospace() << "Found item with guid “" << item.guid() << "“ in the database. "
-                                                                << "Updating it.";
-
-                        if (Q_LIKELY(q.prepare(uR"-(UPDATE items SET title = :title, description = :description, author = :author, link = :link, "pubDate" = :pubDate
-                                                    WHERE guid = :guid)-"_s))) {
-                            q.bindValue(u":title"_s, item.title());
-                            q.bindValue(u":description"_s, Utils::cleanDescription(item.description()));
-                            q.bindValue(u":author"_s, item.author());
-                            q.bindValue(u":link"_s, item.link());
-                            q.bindValue(u":pubDate"_s, item.pubDate());
-
-                            if (Q_LIKELY(q.exec())) {
-                                updatedItems << item;
-                            } else {
-                                qCWarning(ST_UPDATER).noquote().nospace() << "Failed to execute query to update item with guid “" << item.guid()
-                                                                          << "” in the database: " << q.lastError().text();
-                            }
-
-                        } else {
-                            qCWarning(ST_UPDATER).noquote().nospace() << "Failed to prepare query to update item with guid “" << item.guid()
-                                                                      << "” in the database: " << q.lastError().text();
-                        }
-                    }
-
-                } else {
-                    qCDebug(ST_UPDATER).noquote().nospace() << "Can not find item with guid “" << item.guid() << "“ in the database. "
-                                                            << "Must be new. Will insert it.";
-
-                    if (Q_LIKELY(q.prepare(uR"-(INSERT INTO items ("feedId", guid, title, description, author, link, "pubDate")
-                                                VALUES (:feedId, :guid, :title, :description, :author, :link, :pubDate))-"_s))) {
-
-                        q.bindValue(u":feedId"_s, m_current.id);
-                        q.bindValue(u":guid"_s, item.guid());
-                        q.bindValue(u":title"_s, item.title());
-                        q.bindValue(u":description"_s, Utils::cleanDescription(item.description()));
-                        q.bindValue(u":author"_s, item.author());
-                        q.bindValue(u":link"_s, item.link());
-                        q.bindValue(u":pubDate"_s, item.pubDate());
-
-                        if (Q_LIKELY(q.exec())) {
-                            newItems << item;
-                        } else {
-                            qCWarning(ST_UPDATER).noquote().nospace() << "Failed to exceute query to insert item with guid “" << item.guid()
-                                                                      << "” into the database: " << q.lastError().text();
-                        }
-
-                    } else {
-                        qCWarning(ST_UPDATER).noquote().nospace() << "Failed to prepare query to insert item with guid “" << item.guid()
-                                                                  << "” into the database: " << q.lastError().text();
-                    }
-
-                }
-            } else {
-                qCWarning(ST_UPDATER).noquote().nospace() << "Failed to execute query to select item with guid “"
-                                                          << item.guid() << "“ from the database: " << q.lastError().text();
-            }
-        } else {
-            qCWarning(ST_UPDATER).noquote().nospace() << "Failed to prepare query to select item with guid “"
-                                                      << item.guid() << "“ from the database: " << q.lastError().text();
-        }
+    ItemStore store{HBNST_DBCONNAME};
+    store.loadConfig(this);
+    if (Q_UNLIKELY(!store.upsert(current.id, feed.items(), &newItems, &updatedItems) || !db.commit())) {
+        const QString error = store.lastError().isValid() ? store.lastError().text() : db.lastError().text();
+        db.rollback();
+        printFeedFailed(current);
+        qCWarning(ST_UPDATER).noquote().nospace() << "Failed to write items of feed " << current.logInfo()
+                                                  << " to the database: " << error;
+        //% "Failed to write feed items to the database: %1"
+        printWarning(qtTrId("statalihcmd-warn-feeds-update-items-failed").arg(error));
+        feedFailed(current);
+        feedFinished();
+        return;
     }
 
     if (newItems.empty() && updatedItems.empty()) {
-        printDone();
-        qCInfo(ST_UPDATER).noquote().nospace() << "Finished updating feed " << m_current.logInfo()
+        printFeedDone(current);
+        qCInfo(ST_UPDATER).noquote().nospace() << "Finished updating feed " << current.logInfo()
                                                << ". No new or updated items.";
-        QMetaObject::invokeMethod(this, "updateFeed");
+        feedFinished();
     } else {
-        qCInfo(ST_UPDATER).noquote().nospace() << "Finished updating feed " << m_current.logInfo()
+        qCInfo(ST_UPDATER).noquote().nospace() << "Finished updating feed " << current.logInfo()
                                                << " in the database. " << newItems.size() << " new items "
                                                << "and " << updatedItems.size() << " updated items.";
         QList<FeedItem> _items = newItems;
         _items.append(updatedItems);
 
-        qCInfo(ST_UPDATER).noquote() << "Start fetching images for new and updated items of feed" << m_current.logInfo();
-        auto iie = new ItemImageExtractor(this);
-        connect(iie, &ItemImageExtractor::finished, this, &FeedsUpdateCommand::imagesFetched);
+        qCInfo(ST_UPDATER).noquote() << "Start fetching images for new and updated items of feed" << current.logInfo();
+        auto iie = new ItemImageExtractor(m_scheduler, this);
+        iie->loadConfig(this);
+        iie->setCacheConnectionName(HBNST_DBCONNAME);
+        connect(iie, &ItemImageExtractor::finished, this, [this, current, iie](const QVariantMap &itemImages, const QMap<QString,QString> &errors){
+            ItemStore store{HBNST_DBCONNAME};
+            if (Q_UNLIKELY(!store.addImageStats(current.id, iie->imagesFromFeed(), iie->pagesScraped()))) {
+                qCWarning(ST_UPDATER).noquote() << "Failed to update image statistics of feed" << current.logInfo()
+                                                << "in the database:" << store.lastError().text();
+            }
+            imagesFetched(current, itemImages, errors);
+        });
         iie->start(_items);
     }
 }
 
-void FeedsUpdateCommand::imagesFetched(const QVariantMap &itemImages, const QMap<QString,QString> &errors)
+void FeedsUpdateCommand::imagesFetched(const FeedStruct &current, const QVariantMap &itemImages, const QMap<QString,QString> &errors)
 {
     if (!itemImages.empty()) {
         qCInfo(ST_UPDATER).noquote().nospace()
-                << "Finished fetching images for items of feed " << m_current.logInfo()
+                << "Finished fetching images for items of feed " << current.logInfo()
                 << ": found " << itemImages.size() << " images";
 
-        QSqlQuery q{QSqlDatabase::database(HBNST_DBCONNAME)};
-
-        for (auto i = itemImages.constBegin(), end = itemImages.constEnd(); i != end; ++i) {
-            const QString guid = i.key();
-
-            if (Q_UNLIKELY(!q.prepare(uR"-(SELECT data FROM items WHERE guid = :guid)-"_s))) {
-                qCWarning(ST_UPDATER).nospace().noquote()
-                        << "Failed to prepare database query to get data "
-                        << "for item with guid “" << guid << "”: " << q.lastError().text();
-                continue;
-            }
-            q.bindValue(u":guid"_s, guid);
-            if (Q_UNLIKELY(!q.exec())) {
-                qCWarning(ST_UPDATER).nospace().noquote()
-                        << "Failed to execute database query to get data "
-                        << "for item with guid “" << guid << "”: " << q.lastError().text();
-                continue;
-            }
-            if (Q_UNLIKELY(!q.next())) {
-                qCWarning(ST_UPDATER).nospace().noquote()
-                        << "Failed to find item with guid “" << guid << "”.";
-            } else {
-                auto data = q.value(0).toJsonObject();
-                data.insert("image"_L1, QJsonObject::fromVariantMap(i.value().toMap()));
-
-                if (Q_UNLIKELY(!q.prepare(uR"-(UPDATE items SET data = :data WHERE guid = :guid)-"_s))) {
-                    qCWarning(ST_UPDATER).noquote().nospace()
-                            << "Failed to prepare database query to update data "
-                            << "for item with guid “" << guid << "”: " << q.lastError().text();
-                    continue;
-                }
-
-                q.bindValue(u":data"_s, QString::fromUtf8(QJsonDocument(data).toJson(QJsonDocument::Compact)));
-
-                if (Q_UNLIKELY(!q.exec())) {
-                    qCWarning(ST_UPDATER).noquote().nospace()
-                            << "Failed to execute database query to update data "
-                            << "for item with guid “" << guid << "”: " << q.lastError().text();
-                }
-            }
+        auto db = QSqlDatabase::database(HBNST_DBCONNAME);
+        ItemStore store{HBNST_DBCONNAME};
+        if (Q_UNLIKELY(!db.transaction() || !store.setImages(itemImages) || !db.commit())) {
+            const QString error = store.lastError().isValid() ? store.lastError().text() : db.lastError().text();
+            db.rollback();
+            qCWarning(ST_UPDATER).noquote().nospace() << "Failed to write item images of feed " << current.logInfo()
+                                                      << " to the database: " << error;
         }
     } else {
-        qCInfo(ST_UPDATER).noquote().nospace() << "Finished fetching images for items of feed" << m_current.logInfo()
+        qCInfo(ST_UPDATER).noquote().nospace() << "Finished fetching images for items of feed" << current.logInfo()
                                                << ": Nothing to do.";
     }
 
-    printDone();
-    qCInfo(ST_UPDATER).noquote() << "Finished updating feed" << m_current.logInfo();
-    QMetaObject::invokeMethod(this, "updateFeed");
+    printFeedDone(current);
+    qCInfo(ST_UPDATER).noquote() << "Finished updating feed" << current.logInfo();
+    feedFinished();
 }
 
 QString FeedsUpdateCommand::summary() const
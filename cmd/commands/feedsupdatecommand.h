@@ -8,13 +8,17 @@
 
 #include "command.h"
 #include "feed.h"
+#include "feedschedule.h"
+#include "logging.h"
 
 #include <QDateTime>
 #include <QQueue>
 #include <QUrl>
 
-class QNetworkAccessManager;
+class FeedParser;
+class HostScheduler;
 class QNetworkReply;
+class QSqlQuery;
 
 class FeedsUpdateCommand : public Command
 {
@@ -29,21 +33,20 @@ public:
 
     [[nodiscard]] QString description() const override;
 
-private slots:
+protected slots:
     void updateFeed();
-    void feedFetched(QNetworkReply *reply);
-    void feedParsed(const Feed &feed);
-    void imagesFetched(const QVariantMap &itemImages, const QMap<QString,QString> &errors);
-
-private:
-    void init();
 
+protected:
     struct FeedStruct {
         int id;
         QString title;
         QUrl source;
         QDateTime lastBuildDate;
         QDateTime lastFetch;
+        QString etag;
+        QString lastModified;
+        QByteArray contentHash;
+        QDateTime nextFetch;
 
         [[nodiscard]] QString logInfo() const noexcept
         {
@@ -51,10 +54,63 @@ private:
         }
     };
 
+    /*!
+     * \brief Returns the columns of the feeds table that are needed to fill a FeedStruct.
+     *
+     * The feeds table has to be aliased as \c f in the query.
+     */
+    [[nodiscard]] static QString feedColumns();
+
+    /*!
+     * \brief Creates a FeedStruct from the current row of \a q that selected feedColumns().
+     */
+    [[nodiscard]] static FeedStruct feedFromQuery(const QSqlQuery &q);
+
+    void addConcurrencyOption();
+    [[nodiscard]] bool parseConcurrency(QCommandLineParser *parser);
+
+    /*!
+     * \brief Creates the HostScheduler and starts updating the feeds in the queue.
+     */
+    void startUpdates();
+
+    /*!
+     * \brief Called when the queue is empty and no update is running anymore.
+     *
+     * The default implementation exits the command.
+     */
+    virtual void updatesFinished();
+
+    /*!
+     * \brief Called when fetching, parsing or storing the \a current feed has failed.
+     *
+     * The default implementation does nothing.
+     */
+    virtual void feedFailed(const FeedStruct &current);
+
     QQueue<FeedStruct> m_feedsToUpdate;
-    FeedStruct m_current;
-    Feed m_feed;
-    QNetworkAccessManager *m_nam{nullptr};
+    FeedSchedule m_schedule;
+    HostScheduler *m_scheduler{nullptr};
+    int m_concurrency{1};
+    int m_inFlight{0};
+
+private:
+    struct FetchInfo {
+        QString etag;
+        QString lastModified;
+        QByteArray contentHash;
+    };
+
+    void init();
+    void feedFetched(const FeedStruct &current, QNetworkReply *reply, FeedParser *parser);
+    void feedParsed(const FeedStruct &current, const Feed &feed, const FetchInfo &fetchInfo);
+    void feedUnchanged(const FeedStruct &current, const FetchInfo &fetchInfo, const Feed &feed = {});
+    [[nodiscard]] QDateTime calculateNextFetch(const FeedStruct &current, const Feed &feed) const;
+    void imagesFetched(const FeedStruct &current, const QVariantMap &itemImages, const QMap<QString,QString> &errors);
+    void feedFinished();
+    void printFeedStatus(const FeedStruct &current) const;
+    void printFeedDone(const FeedStruct &current) const;
+    void printFeedFailed(const FeedStruct &current) const;
 
     Q_DISABLE_COPY(FeedsUpdateCommand);
 };
@@ -0,0 +1,215 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "feedswatchcommand.h"
+#include "confignames.h"
+
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTimer>
+
+#include <algorithm>
+
+extern "C" {
+#ifdef WITH_SYSTEMD
+#include <systemd/sd-daemon.h>
+#endif
+}
+
+using namespace Qt::Literals::StringLiterals;
+
+#define HBNST_DBCONNAME u"dbcon"_s
+
+FeedsWatchCommand::FeedsWatchCommand(QObject *parent)
+    : FeedsUpdateCommand{parent}
+{
+    setObjectName("watch");
+}
+
+void FeedsWatchCommand::init()
+{
+    m_cliOptions.emplace_back(QStringList({u"i"_s, u"interval"_s}),
+                              //: CLI option description
+                              //% "Interval in minutes after that a feed will be fetched again. Default: value from the configuration file."
+                              qtTrId("statalihcmd-opt-feeds-watch-interval-desc"),
+                              // source string defined in feedsupdatecommand.cpp
+                              qtTrId("statalihcmd-opt-value-number"));
+
+    addConcurrencyOption();
+}
+
+void FeedsWatchCommand::exec(QCommandLineParser *parser)
+{
+    init();
+
+    parser->addOptions(m_cliOptions);
+    parser->parse(QCoreApplication::arguments());
+
+    if (checkShowHelp(parser)) {
+        exit(RC::OK);
+        return;
+    }
+
+    setGlobalOptions(parser);
+
+    // source string defined in feedsaddcommand.cpp
+    printStatus(qtTrId("statalihcmd-status-parsing-input"));
+
+    if (!parseConcurrency(parser)) {
+        return;
+    }
+
+    int interval = 0;
+    if (parser->isSet(u"interval"_s)) {
+        bool ok = false;
+        interval = parser->value(u"interval"_s).toInt(&ok);
+        if (!ok || interval < 1) {
+            printFailed();
+            qCCritical(ST_UPDATER) << "Invalid update interval.";
+            //% "Invalid update interval. Has to be a number of minutes greater than 0."
+            exit(inputError(qtTrId("statalihcmd-err-feeds-watch-invalid-interval")));
+            return;
+        }
+    }
+
+    printDone();
+
+    const CLI::RC rc = openDb(HBNST_DBCONNAME);
+    if (rc != RC::OK) {
+        exit(rc);
+        return;
+    }
+
+    if (interval == 0) {
+        interval = value(QStringLiteral(HBNST_CONF_FEEDS), QStringLiteral(HBNST_CONF_FEEDS_UPDATEINTERVAL), HBNST_CONF_FEEDS_UPDATEINTERVAL_DEFVAL).toInt();
+    }
+    m_interval = std::chrono::minutes{std::max(interval, 1)};
+
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &FeedsWatchCommand::checkDueFeeds);
+
+    startWatchdog();
+
+#ifdef WITH_SYSTEMD
+    sd_notify(0, "READY=1");
+    connect(qApp, &QCoreApplication::aboutToQuit, this, []{
+        sd_notify(0, "STOPPING=1");
+    });
+#endif
+
+    qCInfo(ST_UPDATER) << "Start watching feeds with an update interval of" << m_interval.count() << "minutes";
+
+    QMetaObject::invokeMethod(this, &FeedsWatchCommand::checkDueFeeds, Qt::QueuedConnection);
+}
+
+QString FeedsWatchCommand::summary() const
+{
+    //: CLI command summary
+    //% "Continuously update web feeds"
+    return qtTrId("statalihcmd-command-feeds-watch-summary");
+}
+
+QString FeedsWatchCommand::description() const
+{
+    //: CLI command description
+    //% "Runs until it is stopped and updates every enabled web feed when its update interval has elapsed."
+    return qtTrId("statalihcmd-command-feeds-watch-description");
+}
+
+void FeedsWatchCommand::checkDueFeeds()
+{
+    // an update round is still running, checkDueFeeds() will be called again when it has finished
+    if (m_inFlight > 0 || !m_feedsToUpdate.empty()) {
+        return;
+    }
+
+    QSqlQuery q{QSqlDatabase::database(HBNST_DBCONNAME)};
+
+    if (Q_UNLIKELY(!q.exec(u"SELECT "_s + feedColumns() + u" FROM feeds f WHERE f.enabled = true"_s))) {
+        qCCritical(ST_UPDATER) << "Failed to execute query to get feeds to update from database:" << q.lastError().text();
+        exit(dbError(q));
+        return;
+    }
+
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    QDateTime nextCheck = now.addDuration(m_interval);
+
+    while (q.next()) {
+        const FeedStruct feed = feedFromQuery(q);
+
+        QDateTime due = now;
+        if (feed.nextFetch.isValid()) {
+            due = feed.nextFetch.toUTC();
+        } else if (feed.lastFetch.isValid()) {
+            due = feed.lastFetch.toUTC().addDuration(m_interval);
+        }
+        // failed feeds have no new next fetch time, they are not retried before the back off has elapsed
+        const QDateTime notBefore = m_notBefore.value(feed.id);
+        if (notBefore.isValid() && notBefore > due) {
+            due = notBefore;
+        }
+
+        if (due <= now) {
+            m_feedsToUpdate.enqueue(feed);
+            m_notBefore.remove(feed.id);
+        } else {
+            nextCheck = std::min(nextCheck, due);
+        }
+    }
+
+    if (m_feedsToUpdate.empty()) {
+        qCDebug(ST_UPDATER) << "No feeds due for update, next check at" << nextCheck;
+        notifyStatus(u"Waiting for feeds to become due"_s);
+        m_timer->start(std::max(std::chrono::milliseconds{now.msecsTo(nextCheck)}, std::chrono::milliseconds{1000}));
+        return;
+    }
+
+    notifyStatus(u"Updating %1 feeds"_s.arg(m_feedsToUpdate.size()));
+    startUpdates();
+}
+
+void FeedsWatchCommand::updatesFinished()
+{
+    qCInfo(ST_UPDATER) << "Finished update round";
+    QMetaObject::invokeMethod(this, &FeedsWatchCommand::checkDueFeeds, Qt::QueuedConnection);
+}
+
+void FeedsWatchCommand::feedFailed(const FeedStruct &current)
+{
+    m_notBefore.insert(current.id, QDateTime::currentDateTimeUtc().addDuration(m_interval));
+}
+
+void FeedsWatchCommand::startWatchdog()
+{
+#ifdef WITH_SYSTEMD
+    uint64_t usec = 0;
+    if (sd_watchdog_enabled(0, &usec) > 0 && usec > 0) {
+        auto watchdog = new QTimer(this);
+        // notify twice per watchdog interval to not miss the deadline on a busy event loop
+        watchdog->setInterval(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::microseconds{usec / 2}));
+        connect(watchdog, &QTimer::timeout, this, []{
+            sd_notify(0, "WATCHDOG=1");
+        });
+        watchdog->start();
+        qCDebug(ST_UPDATER) << "Serving systemd watchdog every" << watchdog->interval() << "ms";
+    }
+#endif
+}
+
+void FeedsWatchCommand::notifyStatus(const QString &status) const
+{
+#ifdef WITH_SYSTEMD
+    sd_notifyf(0, "STATUS=%s", status.toUtf8().constData());
+#else
+    Q_UNUSED(status)
+#endif
+}
+
+#include "moc_feedswatchcommand.cpp"
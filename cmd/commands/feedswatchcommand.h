@@ -0,0 +1,57 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef HBNST_FEEDSWATCHCOMMAND_H
+#define HBNST_FEEDSWATCHCOMMAND_H
+
+#include "feedsupdatecommand.h"
+
+#include <QHash>
+
+#include <chrono>
+
+class QTimer;
+
+/*!
+ * \brief Long running command that updates all enabled feeds when they are due.
+ *
+ * In contrast to FeedsUpdateCommand this keeps the database connection and the
+ * HostScheduler with its network access manager alive between the update rounds,
+ * so connections and TLS sessions can be reused. If built with systemd support,
+ * the service manager is notified about the state and the watchdog is served.
+ */
+class FeedsWatchCommand final : public FeedsUpdateCommand
+{
+    Q_OBJECT
+public:
+    explicit FeedsWatchCommand(QObject *parent = nullptr);
+    ~FeedsWatchCommand() override = default;
+
+    void exec(QCommandLineParser *parser) override;
+
+    [[nodiscard]] QString summary() const override;
+
+    [[nodiscard]] QString description() const override;
+
+protected:
+    void updatesFinished() override;
+    void feedFailed(const FeedStruct &current) override;
+
+private slots:
+    void checkDueFeeds();
+
+private:
+    void init();
+    void startWatchdog();
+    void notifyStatus(const QString &status) const;
+
+    QHash<int,QDateTime> m_notBefore;
+    QTimer *m_timer{nullptr};
+    std::chrono::minutes m_interval{0};
+
+    Q_DISABLE_COPY(FeedsWatchCommand)
+};
+
+#endif // HBNST_FEEDSWATCHCOMMAND_H
@@ -4,13 +4,11 @@
  */
 
 #include "commands/placeslistcommand.h"
+#include "jsonstreamwriter.h"
 #include "utils.h"
 
 #include <QCommandLineOption>
 #include <QCommandLineParser>
-#include <QJsonArray>
-#include <QJsonDocument>
-#include <QJsonObject>
 #include <QSqlDatabase>
 #include <QSqlError>
 #include <QSqlQuery>
@@ -36,7 +34,14 @@ void PlacesListCommand::init()
                               // source string defined in feedsaddcommand.cpp
                               qtTrId("statalihcmd-opt-value-text"));
 
-    addOutputFormatOption();
+    addPaginationOptions(
+        //: CLI option description
+        //% "Only show places with an ID greater than the given ID."
+        qtTrId("statalihcmd-opt-places-list-after-desc"),
+        // source string defined in placesaddcommand.cpp
+        qtTrId("statlihcmd-opt-value-dbid"));
+
+    addOutputFormatOption(true);
 }
 
 void PlacesListCommand::exec(QCommandLineParser *parser)
@@ -60,22 +65,70 @@ void PlacesListCommand::exec(QCommandLineParser *parser)
     }
 
     const QString outputFormat = parser->value(u"format"_s).toLower();
+    const auto jsonFormat = JsonStreamWriter::formatFromName(outputFormat);
+
+    // source string defined in feedsaddcommand.cpp
+    printStatus(qtTrId("statalihcmd-status-parsing-input"));
+
+    const auto limit = parseLimit(parser);
+    if (!limit) {
+        return;
+    }
+
+    int afterId = 0;
+    if (parser->isSet(u"after"_s)) {
+        bool ok = false;
+        afterId = parser->value(u"after"_s).toInt(&ok);
+        if (!ok || afterId < 1) {
+            printFailed();
+            // source string defined in feedslistcommand.cpp
+            exit(inputError(qtTrId("statalihcmd-err-invalid-after-id")));
+            return;
+        }
+    }
+
+    printDone();
 
     //% "Querying database"
     printStatus(qtTrId("statalihcmd-status-query-db"));
 
     QSqlQuery q{QSqlDatabase::database(HBNST_DBCONNAME)};
+    // the rows are not cached on the client and are fetched in single row mode by the driver
+    q.setForwardOnly(true);
 
     QString qs;
-    if (outputFormat == "json"_L1 || outputFormat == "json-pretty"_L1) {
-        qs = u"SELECT * FROM places"_s;
+    if (jsonFormat) {
+        qs = u"SELECT p.*"_s;
     } else {
-        qs = uR"-(SELECT id, name, slug, parent, "administrativeId", coords, link, created, updated FROM places)-"_s;
+        qs = uR"-(SELECT p.id, p.name, p.slug, p.parent, p."administrativeId", p.coords, p.link, p.created, p.updated)-"_s;
     }
+    // the statistics are aggregated per returned place in the same query, so only the places
+    // of the requested page are aggregated using the indexes on feeds and items
+    qs += uR"-(, fc.feeds, ic.items, ic."lastItem"
+               FROM places p
+               LEFT JOIN LATERAL (SELECT count(*) AS feeds FROM feeds f WHERE f."placeId" = p.id) fc ON true
+               LEFT JOIN LATERAL (SELECT count(*) AS items, max(i."pubDate") AS "lastItem" FROM items i JOIN feeds f ON f.id = i."feedId" WHERE f."placeId" = p.id) ic ON true)-"_s;
+
+    QStringList where;
 
     QString search = parser->value(u"search"_s);
     if (!search.isEmpty()) {
-        qs += uR"-( WHERE name ILIKE :search OR slug ILIKE :search)-"_s;
+        where << u"(p.name ILIKE :search OR p.slug ILIKE :search)"_s;
+    }
+
+    if (afterId > 0) {
+        where << u"p.id > :afterId"_s;
+    }
+
+    if (!where.empty()) {
+        qs += " WHERE "_L1;
+        qs += where.join(" AND "_L1);
+    }
+
+    qs += u" ORDER BY p.id"_s;
+
+    if (*limit > 0) {
+        qs += u" LIMIT :limit"_s;
     }
 
     if (Q_UNLIKELY(!q.prepare(qs))) {
@@ -90,6 +143,14 @@ void PlacesListCommand::exec(QCommandLineParser *parser)
         q.bindValue(u":search"_s, search);
     }
 
+    if (afterId > 0) {
+        q.bindValue(u":afterId"_s, afterId);
+    }
+
+    if (*limit > 0) {
+        q.bindValue(u":limit"_s, *limit);
+    }
+
     if (Q_UNLIKELY(!q.exec())) {
         printFailed();
         exit(dbError(q));
@@ -98,19 +159,18 @@ void PlacesListCommand::exec(QCommandLineParser *parser)
 
     printDone();
 
-    if (q.size() == 0) {
+    // forward only queries have no size, so the first row is fetched to check for an empty result
+    if (!q.next()) {
         //% "Your query has not returned any result."
         printWarning(qtTrId("statlihcmd-warn-places-list-nothing-found"));
         exit(RC::OK);
         return;
     }
 
-    if (outputFormat == "json"_L1 || outputFormat == "json-pretty"_L1) {
+    if (jsonFormat) {
 
-        const auto jsonArray = Utils::queryToJsonObjectArray(q);
-        const QJsonDocument json(jsonArray);
-        QTextStream out(stdout, QIODeviceBase::WriteOnly);
-        out << json.toJson(outputFormat == "json"_L1 ? QJsonDocument::Compact : QJsonDocument::Indented);
+        JsonStreamWriter writer{*jsonFormat};
+        writer.writeQuery(q);
 
     } else {
         const QStringList headers{
@@ -138,6 +198,12 @@ void PlacesListCommand::exec(QCommandLineParser *parser)
             //: CLI table header, means the numer of feeds
             //% "Feeds"
             qtTrId("statalihcmd-places-list-table-header-feeds"),
+            //: CLI table header, means the number of feed items
+            //% "Items"
+            qtTrId("statalihcmd-places-list-table-header-items"),
+            //: CLI table header, means the publication date of the newest feed item
+            //% "Last Item"
+            qtTrId("statalihcmd-places-list-table-header-lastitem"),
             //: CLI table header
             //% "Created"
             qtTrId("statalihcmd-table-header-created"),
@@ -148,9 +214,11 @@ void PlacesListCommand::exec(QCommandLineParser *parser)
 
         QLocale locale;
         QList<QStringList> data;
-        while (q.next()) {
+        int lastId = 0;
+        do {
             QStringList row;
             const auto id = q.value(0).toInt();
+            lastId = id;
             row << QString::number(id);
             row << q.value(1).toString();
             row << q.value(2).toString();
@@ -165,12 +233,14 @@ void PlacesListCommand::exec(QCommandLineParser *parser)
             }
             row << q.value(6).toString();
 
-            QSqlQuery qq{QSqlDatabase::database(HBNST_DBCONNAME)};
-            qq.prepare(uR"-(SELECT COUNT(*) FROM feeds WHERE "placeId" = :placeId)-"_s);
-            qq.bindValue(u":placeId"_s, id);
-            qq.exec();
-            qq.next();
-            row << locale.toString(qq.value(0).toInt());
+            row << locale.toString(q.value(9).toInt());
+            row << locale.toString(q.value(10).toLongLong());
+            const auto lastItem = q.value(11).toDateTime();
+            if (lastItem.isValid()) {
+                row << locale.toString(lastItem.toLocalTime(), QLocale::ShortFormat);
+            } else {
+                row << QString();
+            }
 
             row << locale.toString(q.value(7).toDateTime().toLocalTime(), QLocale::ShortFormat);
             const auto updated = q.value(8).toDateTime();
@@ -181,9 +251,14 @@ void PlacesListCommand::exec(QCommandLineParser *parser)
             }
 
             data << row;
-        }
+        } while (q.next());
 
         printTable(headers, data);
+
+        if (*limit > 0 && data.size() == *limit) {
+            // source string defined in feedslistitemscommand.cpp
+            printMessage(qtTrId("statalihcmd-msg-feeds-listitems-next-page").arg(lastId));
+        }
     }
 
     exit(RC::OK);
@@ -0,0 +1,442 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "dateparser.h"
+
+#include <QDate>
+#include <QTime>
+#include <QTimeZone>
+
+#include <algorithm>
+#include <array>
+#include <optional>
+
+using namespace Qt::StringLiterals;
+
+namespace {
+
+struct MonthName {
+    QLatin1StringView prefix;
+    int month;
+};
+
+// matched against the beginning of the lowercased month token, so full and
+// abbreviated names with or without trailing dot are covered by one entry
+constexpr std::array<MonthName,38> monthNames{{
+    {"jan"_L1, 1}, {"ene"_L1, 1}, {"gen"_L1, 1},
+    {"feb"_L1, 2}, {"f\xe9v"_L1, 2}, {"fev"_L1, 2},
+    {"mar"_L1, 3}, {"m\xe4r"_L1, 3}, {"mrz"_L1, 3}, {"mrt"_L1, 3}, {"maa"_L1, 3},
+    {"apr"_L1, 4}, {"avr"_L1, 4}, {"abr"_L1, 4},
+    {"may"_L1, 5}, {"mai"_L1, 5}, {"mag"_L1, 5}, {"mei"_L1, 5},
+    {"jun"_L1, 6}, {"juin"_L1, 6}, {"giu"_L1, 6},
+    {"jul"_L1, 7}, {"juil"_L1, 7}, {"lug"_L1, 7},
+    {"aug"_L1, 8}, {"ao\xfb"_L1, 8}, {"aou"_L1, 8}, {"ago"_L1, 8},
+    {"sep"_L1, 9}, {"set"_L1, 9},
+    {"oct"_L1, 10}, {"okt"_L1, 10}, {"ott"_L1, 10},
+    {"nov"_L1, 11},
+    {"dec"_L1, 12}, {"d\xe9""c"_L1, 12}, {"dez"_L1, 12}, {"dic"_L1, 12}
+}};
+
+struct ZoneName {
+    QLatin1StringView name;
+    int offsetHours;
+};
+
+// ambiguous abbreviations like IST are not part of the list, dates using them are rejected
+constexpr std::array<ZoneName,28> zoneNames{{
+    {"gmt"_L1, 0}, {"ut"_L1, 0}, {"utc"_L1, 0}, {"z"_L1, 0},
+    {"est"_L1, -5}, {"edt"_L1, -4}, {"cst"_L1, -6}, {"cdt"_L1, -5},
+    {"mst"_L1, -7}, {"mdt"_L1, -6}, {"pst"_L1, -8}, {"pdt"_L1, -7},
+    {"akst"_L1, -9}, {"akdt"_L1, -8}, {"hst"_L1, -10},
+    {"wet"_L1, 0}, {"west"_L1, 1}, {"bst"_L1, 1},
+    {"cet"_L1, 1}, {"cest"_L1, 2}, {"mez"_L1, 1}, {"mesz"_L1, 2},
+    {"eet"_L1, 2}, {"eest"_L1, 3}, {"msk"_L1, 3},
+    {"jst"_L1, 9}, {"aest"_L1, 10}, {"aedt"_L1, 11}
+}};
+
+/*!
+ * \internal
+ * \brief Reads the date string character by character without creating temporary strings.
+ */
+class Cursor
+{
+public:
+    explicit Cursor(QStringView text) : m_text{text} {}
+
+    [[nodiscard]] bool atEnd() const noexcept { return m_pos >= m_text.size(); }
+
+    [[nodiscard]] QChar peek(qsizetype offset = 0) const noexcept
+    {
+        return m_pos + offset < m_text.size() ? m_text.at(m_pos + offset) : QChar();
+    }
+
+    void advance(qsizetype n = 1) noexcept { m_pos += n; }
+
+    [[nodiscard]] qsizetype pos() const noexcept { return m_pos; }
+
+    void reset(qsizetype pos) noexcept { m_pos = pos; }
+
+    void skipSpaces() noexcept
+    {
+        while (!atEnd() && peek().isSpace()) {
+            ++m_pos;
+        }
+    }
+
+    void skipSeparators() noexcept
+    {
+        while (!atEnd()) {
+            const QChar c = peek();
+            if (!c.isSpace() && c != ','_L1 && c != '-'_L1 && c != '.'_L1 && c != '/'_L1) {
+                break;
+            }
+            ++m_pos;
+        }
+    }
+
+    /*!
+     * \brief Reads up to \a maxDigits digits, returns \c -1 if there is no digit.
+     */
+    int number(int maxDigits, int *digits = nullptr) noexcept
+    {
+        int value = 0;
+        int count = 0;
+        while (count < maxDigits && !atEnd() && isAsciiDigit(peek())) {
+            value = value * 10 + (peek().unicode() - u'0');
+            ++m_pos;
+            ++count;
+        }
+        if (digits) {
+            *digits = count;
+        }
+        return count > 0 ? value : -1;
+    }
+
+    [[nodiscard]] QStringView word() noexcept
+    {
+        const qsizetype start = m_pos;
+        while (!atEnd() && peek().isLetter()) {
+            ++m_pos;
+        }
+        return m_text.sliced(start, m_pos - start);
+    }
+
+    [[nodiscard]] bool consume(QChar c) noexcept
+    {
+        if (peek() == c) {
+            ++m_pos;
+            return true;
+        }
+        return false;
+    }
+
+    static bool isAsciiDigit(QChar c) noexcept
+    {
+        return c.unicode() >= u'0' && c.unicode() <= u'9';
+    }
+
+private:
+    QStringView m_text;
+    qsizetype m_pos{0};
+};
+
+bool startsWithCaseInsensitive(QStringView word, QLatin1StringView prefix) noexcept
+{
+    if (word.size() < prefix.size()) {
+        return false;
+    }
+    for (qsizetype i = 0; i < prefix.size(); ++i) {
+        if (word.at(i).toLower() != QChar{prefix.at(i)}) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int monthFromName(QStringView word) noexcept
+{
+    if (word.size() < 3) {
+        return 0;
+    }
+    for (const auto &name : monthNames) {
+        if (startsWithCaseInsensitive(word, name.prefix)) {
+            return name.month;
+        }
+    }
+    return 0;
+}
+
+int expandYear(int year, int digits) noexcept
+{
+    if (digits <= 2) {
+        return year < 50 ? 2000 + year : 1900 + year;
+    }
+    return year;
+}
+
+/*!
+ * \internal
+ * \brief Reads a numeric offset like \c +0200, \c +02:00 or \c +2 and returns it in seconds.
+ */
+bool parseOffset(Cursor &c, int *offsetSecs) noexcept
+{
+    const QChar sign = c.peek();
+    if (sign != '+'_L1 && sign != '-'_L1 && sign != QChar{0x2212}) {
+        return false;
+    }
+    c.advance();
+
+    int digits = 0;
+    int hours = c.number(2, &digits);
+    if (hours < 0) {
+        return false;
+    }
+    int minutes = 0;
+    if (c.consume(':'_L1)) {
+        minutes = std::max(c.number(2), 0);
+    } else if (digits == 2 && Cursor::isAsciiDigit(c.peek())) {
+        minutes = std::max(c.number(2), 0);
+    }
+
+    if (hours > 14 || minutes > 59) {
+        return false;
+    }
+
+    *offsetSecs = (hours * 3600 + minutes * 60) * (sign == '+'_L1 ? 1 : -1);
+    return true;
+}
+
+/*!
+ * \internal
+ * \brief Reads the zone designator and returns its offset in seconds.
+ *
+ * A missing zone is treated as UTC. Unknown zone names return \c std::nullopt, because
+ * interpreting them as UTC would silently shift the date by hours.
+ */
+std::optional<int> parseZone(Cursor &c) noexcept
+{
+    c.skipSpaces();
+
+    int offset = 0;
+    if (parseOffset(c, &offset)) {
+        return offset;
+    }
+
+    const QStringView name = c.word();
+    if (!name.isEmpty()) {
+        const auto zone = std::ranges::find_if(zoneNames, [name](const ZoneName &zone){
+            return name.size() == zone.name.size() && startsWithCaseInsensitive(name, zone.name);
+        });
+        if (zone == zoneNames.end()) {
+            return std::nullopt;
+        }
+        offset = zone->offsetHours * 3600;
+    }
+
+    // GMT+2, UTC+01:00
+    int extra = 0;
+    if (parseOffset(c, &extra)) {
+        offset += extra;
+    }
+
+    return offset;
+}
+
+/*!
+ * \internal
+ * \brief Reads the time of the day, seconds and fractions are optional.
+ */
+bool parseTime(Cursor &c, QTime *time) noexcept
+{
+    const int hour = c.number(2);
+    if (hour < 0 || !c.consume(':'_L1)) {
+        return false;
+    }
+    const int minute = c.number(2);
+    if (minute < 0) {
+        return false;
+    }
+    int second = 0;
+    int msec = 0;
+    if (c.consume(':'_L1)) {
+        second = std::max(c.number(2), 0);
+        if (c.peek() == '.'_L1 || c.peek() == ','_L1) {
+            c.advance();
+            int digits = 0;
+            msec = std::max(c.number(3, &digits), 0);
+            for (; digits < 3; ++digits) {
+                msec *= 10;
+            }
+            // ignore precision beyond milliseconds
+            while (Cursor::isAsciiDigit(c.peek())) {
+                c.advance();
+            }
+        }
+    }
+
+    // leap seconds can not be represented by QTime
+    if (hour > 23 || minute > 59 || second > 60) {
+        return false;
+    }
+    *time = QTime{hour, minute, std::min(second, 59), msec};
+    return true;
+}
+
+QDateTime makeUtc(int year, int month, int day, QTime time, std::optional<int> offsetSecs)
+{
+    const QDate date{year, month, day};
+    if (!date.isValid() || !time.isValid() || !offsetSecs) {
+        return {};
+    }
+    return QDateTime{date, time, QTimeZone::UTC}.addSecs(-*offsetSecs);
+}
+
+/*!
+ * \internal
+ * \brief Parses RFC 3339 and ISO 8601 dates like \c 2025-03-01T12:30:00+01:00.
+ */
+QDateTime parseIso(Cursor &c)
+{
+    int digits = 0;
+    const int year = c.number(4, &digits);
+    if (digits != 4 || !c.consume('-'_L1)) {
+        return {};
+    }
+    const int month = c.number(2);
+    if (month < 1 || !c.consume('-'_L1)) {
+        return {};
+    }
+    const int day = c.number(2);
+    if (day < 1) {
+        return {};
+    }
+
+    QTime time{0, 0};
+    const QChar sep = c.peek();
+    if (sep == 'T'_L1 || sep == 't'_L1 || sep == ' '_L1) {
+        c.advance();
+        if (!parseTime(c, &time)) {
+            return {};
+        }
+    }
+
+    return makeUtc(year, month, day, time, parseZone(c));
+}
+
+/*!
+ * \internal
+ * \brief Parses RFC 822 and RFC 2822 dates like \c Sat,&nbsp;01&nbsp;Mar&nbsp;2025&nbsp;12:30:00&nbsp;+0100
+ * and similar formats with localized or swapped day and month.
+ */
+QDateTime parseRfc(Cursor &c)
+{
+    int day = -1;
+    int month = 0;
+
+    // the weekday is optional and ignored, it is either followed by a comma
+    // or it is not a month name
+    if (c.peek().isLetter()) {
+        const QStringView first = c.word();
+        month = c.peek() == ','_L1 ? 0 : monthFromName(first);
+        c.skipSeparators();
+    }
+
+    if (month == 0 && c.peek().isLetter()) {
+        month = monthFromName(c.word());
+        if (month == 0) {
+            return {};
+        }
+        c.skipSeparators();
+        day = c.number(2);
+    } else if (month == 0) {
+        day = c.number(2);
+        c.skipSeparators();
+        QStringView name = c.word();
+        // 1 de enero de 2025
+        if (name.compare("de"_L1, Qt::CaseInsensitive) == 0) {
+            c.skipSeparators();
+            name = c.word();
+        }
+        month = monthFromName(name);
+    } else {
+        day = c.number(2);
+        // abbreviated weekdays like the French "mar." can look like month names, in that case
+        // the day is followed by the real month name: mar. 4 mars 2025
+        const qsizetype afterDay = c.pos();
+        c.skipSeparators();
+        QStringView name = c.word();
+        if (name.compare("de"_L1, Qt::CaseInsensitive) == 0) {
+            c.skipSeparators();
+            name = c.word();
+        }
+        if (const int realMonth = monthFromName(name); realMonth > 0) {
+            month = realMonth;
+        } else {
+            c.reset(afterDay);
+        }
+    }
+
+    if (day < 1 || month == 0) {
+        return {};
+    }
+
+    c.skipSeparators();
+    if (c.peek().isLetter()) {
+        // 1 de enero de 2025
+        if (c.word().compare("de"_L1, Qt::CaseInsensitive) != 0) {
+            return {};
+        }
+        c.skipSeparators();
+    }
+
+    const qsizetype yearPos = c.pos();
+    int digits = 0;
+    int year = c.number(4, &digits);
+    QTime time{0, 0};
+    std::optional<int> offset;
+
+    if (year >= 0 && c.peek() == ':'_L1) {
+        // asctime and date(1) have the time in front of the year: Sat Mar  1 12:30:00 UTC 2025
+        c.reset(yearPos);
+        if (!parseTime(c, &time)) {
+            return {};
+        }
+        offset = parseZone(c);
+        c.skipSpaces();
+        year = c.number(4, &digits);
+        if (year < 0) {
+            return {};
+        }
+    } else {
+        if (year < 0) {
+            return {};
+        }
+        c.skipSpaces();
+        if (Cursor::isAsciiDigit(c.peek()) && !parseTime(c, &time)) {
+            return {};
+        }
+        offset = parseZone(c);
+    }
+
+    return makeUtc(expandYear(year, digits), month, day, time, offset);
+}
+
+} // namespace
+
+QDateTime DateParser::parse(QStringView text)
+{
+    Cursor c{text};
+    c.skipSpaces();
+    if (c.atEnd()) {
+        return {};
+    }
+
+    // ISO dates start with a four digit year followed by a dash
+    if (Cursor::isAsciiDigit(c.peek()) && Cursor::isAsciiDigit(c.peek(3)) && c.peek(4) == '-'_L1) {
+        return parseIso(c);
+    }
+
+    return parseRfc(c);
+}
@@ -0,0 +1,27 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef HBNST_DATEPARSER_H
+#define HBNST_DATEPARSER_H
+
+#include <QDateTime>
+#include <QStringView>
+
+namespace DateParser {
+
+/*!
+ * \brief Parses the date and time in \a text and returns it in UTC.
+ *
+ * Accepts RFC 822, RFC 2822 and RFC 3339/ISO 8601 dates as well as common malformed
+ * variants found in web feeds: missing weekday or seconds, two digit years, English,
+ * German, French, Spanish, Italian and Dutch month names, zone names like \c GMT+2 and
+ * missing zones, which are interpreted as UTC. Returns an invalid QDateTime if \a text
+ * can not be parsed.
+ */
+QDateTime parse(QStringView text);
+
+}
+
+#endif // HBNST_DATEPARSER_H
@@ -5,6 +5,8 @@
 
 #include "feed_p.h"
 
+#include <algorithm>
+
 FeedItem::FeedItem() : data(new FeedItemData)
 {}
 
@@ -44,6 +46,11 @@ QDateTime FeedItem::pubDate() const noexcept
     return data->pubDate;
 }
 
+QVariantMap FeedItem::image() const noexcept
+{
+    return data->image;
+}
+
 Feed::Feed() : data(new FeedData)
 {}
 
@@ -107,13 +114,24 @@ QList<FeedItem> Feed::items() const noexcept
     return data->items;
 }
 
+int Feed::ttl() const noexcept
+{
+    return data->ttl;
+}
+
+QList<int> Feed::skipHours() const noexcept
+{
+    return data->skipHours;
+}
+
+std::chrono::seconds Feed::updateInterval() const noexcept
+{
+    return data->updatePeriod / std::max(data->updateFrequency, 1);
+}
+
 bool Feed::isValid() const noexcept
 {
-    if (data->type == Feed::Type::RSS_2_0) {
-        return !data->source.isEmpty();
-    } else {
-        return false;
-    }
+    return data->type != Feed::Type::Invalid && !data->source.isEmpty();
 }
 
 #include "moc_feed.cpp"
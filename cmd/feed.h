@@ -10,6 +10,9 @@
 #include <QObject>
 #include <QSharedDataPointer>
 #include <QUrl>
+#include <QVariantMap>
+
+#include <chrono>
 
 class FeedItemData;
 
@@ -39,6 +42,14 @@ public:
 
     [[nodiscard]] QDateTime pubDate() const noexcept;
 
+    /*!
+     * \brief Returns image data that has been found in the feed itself.
+     *
+     * Uses the same keys as the OpenGraph data found by ItemImageExtractor. The
+     * map is empty if the feed contains no image for this item.
+     */
+    [[nodiscard]] QVariantMap image() const noexcept;
+
 private:
     friend class FeedParser;
     QSharedDataPointer<FeedItemData> data;
@@ -55,7 +66,10 @@ public:
     enum class Type {
         Invalid = 0,
         Atom_1_0 = 1,
-        RSS_2_0 = 2
+        RSS_2_0 = 2,
+        RSS_0_91 = 3,
+        RSS_0_92 = 4,
+        RSS_1_0 = 5
     };
     Q_ENUM(Type)
 
@@ -89,6 +103,24 @@ public:
 
     [[nodiscard]] QList<FeedItem> items() const noexcept;
 
+    /*!
+     * \brief Returns the RSS \c ttl in minutes or \c 0 if it is not set.
+     */
+    [[nodiscard]] int ttl() const noexcept;
+
+    /*!
+     * \brief Returns the hours in UTC from the RSS \c skipHours element.
+     */
+    [[nodiscard]] QList<int> skipHours() const noexcept;
+
+    /*!
+     * \brief Returns the update interval published via the RSS syndication module.
+     *
+     * The interval is calculated from \c sy:updatePeriod and \c sy:updateFrequency.
+     * Returns \c 0 if the feed does not use the syndication module.
+     */
+    [[nodiscard]] std::chrono::seconds updateInterval() const noexcept;
+
     [[nodiscard]] bool isValid() const noexcept;
 
 private:
@@ -17,6 +17,9 @@ public:
     QString author;
     QUrl link;
     QDateTime pubDate;
+    QVariantMap image;
+    // used by the parser to prefer better image sources
+    int imagePriority{0};
 };
 
 class FeedData : public QSharedData
@@ -31,6 +34,10 @@ public:
     QUrl source;
     QDateTime lastBuildDate;
     QList<FeedItem> items;
+    QList<int> skipHours;
+    std::chrono::seconds updatePeriod{0};
+    int updateFrequency{1};
+    int ttl{0};
     Feed::Type type{Feed::Type::Invalid};
 };
 
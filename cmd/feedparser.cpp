@@ -4,101 +4,520 @@
  */
 
 #include "feedparser.h"
+#include "dateparser.h"
 #include "feed_p.h"
 
-#include <QDomDocument>
-#include <QDomElement>
-#include <QDomNodeList>
+#include <QIODevice>
+#include <QRegularExpression>
 #include <QVersionNumber>
 #include <QDebug>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+
 using namespace Qt::StringLiterals;
 
+enum class FeedScope : quint8 {
+    Root,
+    Feed,
+    Item,
+    FeedAuthor,
+    ItemAuthor,
+    SkipHours,
+    MediaGroup,
+    Ignored
+};
+
+namespace {
+
+enum class Ns : quint8 {
+    None,
+    Atom,
+    Rss10,
+    Rdf,
+    Dc,
+    Sy,
+    Content,
+    Media,
+    Unknown
+};
+
+Ns namespaceFromUri(QStringView uri)
+{
+    if (uri.isEmpty()) {
+        return Ns::None;
+    } else if (uri == "http://www.w3.org/2005/Atom"_L1) {
+        return Ns::Atom;
+    } else if (uri == "http://purl.org/rss/1.0/"_L1) {
+        return Ns::Rss10;
+    } else if (uri == "http://www.w3.org/1999/02/22-rdf-syntax-ns#"_L1) {
+        return Ns::Rdf;
+    } else if (uri == "http://purl.org/dc/elements/1.1/"_L1) {
+        return Ns::Dc;
+    } else if (uri == "http://purl.org/rss/1.0/modules/syndication/"_L1) {
+        return Ns::Sy;
+    } else if (uri == "http://purl.org/rss/1.0/modules/content/"_L1) {
+        return Ns::Content;
+    } else if (uri == "http://search.yahoo.com/mrss/"_L1) {
+        return Ns::Media;
+    }
+    return Ns::Unknown;
+}
+
+struct FieldContext {
+    FeedData *feed;
+    FeedItemData *item;
+    QStringView text;
+    const QXmlStreamAttributes &attributes;
+};
+
+std::chrono::seconds syndicationPeriod(QStringView text)
+{
+    using namespace std::chrono_literals;
+    const auto period = text.trimmed();
+    if (period == "hourly"_L1) {
+        return 1h;
+    } else if (period == "daily"_L1) {
+        return 24h;
+    } else if (period == "weekly"_L1) {
+        return 7 * 24h;
+    } else if (period == "monthly"_L1) {
+        return 30 * 24h;
+    } else if (period == "yearly"_L1) {
+        return 365 * 24h;
+    }
+    return 0s;
+}
+
+bool isAlternateLink(const QXmlStreamAttributes &attributes)
+{
+    const auto rel = attributes.value("rel"_L1);
+    return rel.isEmpty() || rel == "alternate"_L1;
+}
+
+bool isImageType(const QXmlStreamAttributes &attributes)
+{
+    return attributes.value("type"_L1).startsWith("image/"_L1);
+}
+
+// image sources in the order of preference, higher values win
+enum ImagePriority : int {
+    HtmlImage = 1,
+    Thumbnail = 2,
+    Enclosure = 3
+};
+
+void setItemImage(FeedItemData *item, QStringView url, const QXmlStreamAttributes &attributes, ImagePriority priority)
+{
+    if (priority <= item->imagePriority) {
+        return;
+    }
+
+    const QUrl imageUrl{url.trimmed().toString()};
+    if (!imageUrl.isValid() || imageUrl.isRelative()) {
+        return;
+    }
+
+    QVariantMap image{{u"url"_s, imageUrl}};
+    bool ok = false;
+    const int width = attributes.value("width"_L1).toInt(&ok);
+    if (ok) {
+        image.insert(u"width"_s, width);
+    }
+    const int height = attributes.value("height"_L1).toInt(&ok);
+    if (ok) {
+        image.insert(u"height"_s, height);
+    }
+    if (isImageType(attributes)) {
+        image.insert(u"type"_s, attributes.value("type"_L1).toString());
+    }
+
+    item->image = image;
+    item->imagePriority = priority;
+}
+
+const QRegularExpression htmlImgRegex{uR"-(<img\s[^>]*?src\s*=\s*["']([^"']+)["'])-"_s, QRegularExpression::CaseInsensitiveOption};
+
+void setItemImageFromHtml(FeedItemData *item, QStringView html)
+{
+    if (item->imagePriority >= HtmlImage) {
+        return;
+    }
+
+    const auto match = htmlImgRegex.matchView(html);
+    if (match.hasMatch()) {
+        setItemImage(item, match.capturedView(1), {}, HtmlImage);
+    }
+}
+
+} // namespace
+
+struct FeedField {
+    Ns ns;
+    QLatin1StringView name;
+    FeedScope scope;
+    void (*handle)(const FieldContext &ctx);
+};
+
+namespace {
+
+constexpr std::array feedFields{
+    // feed/channel fields
+    FeedField{Ns::None, "title"_L1, FeedScope::Feed, [](const FieldContext &ctx) { ctx.feed->title = ctx.text.toString(); }},
+    FeedField{Ns::Rss10, "title"_L1, FeedScope::Feed, [](const FieldContext &ctx) { ctx.feed->title = ctx.text.toString(); }},
+    FeedField{Ns::Atom, "title"_L1, FeedScope::Feed, [](const FieldContext &ctx) { ctx.feed->title = ctx.text.toString(); }},
+    FeedField{Ns::None, "description"_L1, FeedScope::Feed, [](const FieldContext &ctx) { ctx.feed->description = ctx.text.toString(); }},
+    FeedField{Ns::Rss10, "description"_L1, FeedScope::Feed, [](const FieldContext &ctx) { ctx.feed->description = ctx.text.toString(); }},
+    FeedField{Ns::Atom, "subtitle"_L1, FeedScope::Feed, [](const FieldContext &ctx) { ctx.feed->description = ctx.text.toString(); }},
+    FeedField{Ns::None, "link"_L1, FeedScope::Feed, [](const FieldContext &ctx) { ctx.feed->link = QUrl(ctx.text.trimmed().toString()); }},
+    FeedField{Ns::Rss10, "link"_L1, FeedScope::Feed, [](const FieldContext &ctx) { ctx.feed->link = QUrl(ctx.text.trimmed().toString()); }},
+    FeedField{Ns::Atom, "link"_L1, FeedScope::Feed, [](const FieldContext &ctx) {
+        if (ctx.attributes.value("rel"_L1) == "self"_L1) {
+            ctx.feed->source = QUrl(ctx.attributes.value("href"_L1).toString());
+        } else if (isAlternateLink(ctx.attributes) && ctx.feed->link.isEmpty()) {
+            ctx.feed->link = QUrl(ctx.attributes.value("href"_L1).toString());
+        }
+    }},
+    FeedField{Ns::None, "lastBuildDate"_L1, FeedScope::Feed, [](const FieldContext &ctx) { ctx.feed->lastBuildDate = DateParser::parse(ctx.text); }},
+    FeedField{Ns::Atom, "updated"_L1, FeedScope::Feed, [](const FieldContext &ctx) { ctx.feed->lastBuildDate = DateParser::parse(ctx.text); }},
+    FeedField{Ns::Dc, "date"_L1, FeedScope::Feed, [](const FieldContext &ctx) { ctx.feed->lastBuildDate = DateParser::parse(ctx.text); }},
+    FeedField{Ns::None, "generator"_L1, FeedScope::Feed, [](const FieldContext &ctx) { ctx.feed->generator = ctx.text.toString(); }},
+    FeedField{Ns::Atom, "generator"_L1, FeedScope::Feed, [](const FieldContext &ctx) { ctx.feed->generator = ctx.text.toString(); }},
+    FeedField{Ns::None, "language"_L1, FeedScope::Feed, [](const FieldContext &ctx) { ctx.feed->language = ctx.text.trimmed().toString(); }},
+    FeedField{Ns::Dc, "language"_L1, FeedScope::Feed, [](const FieldContext &ctx) { ctx.feed->language = ctx.text.trimmed().toString(); }},
+    FeedField{Ns::None, "managingEditor"_L1, FeedScope::Feed, [](const FieldContext &ctx) { ctx.feed->publisher = ctx.text.toString(); }},
+    FeedField{Ns::Dc, "publisher"_L1, FeedScope::Feed, [](const FieldContext &ctx) { ctx.feed->publisher = ctx.text.toString(); }},
+    FeedField{Ns::None, "ttl"_L1, FeedScope::Feed, [](const FieldContext &ctx) { ctx.feed->ttl = std::max(ctx.text.trimmed().toInt(), 0); }},
+    FeedField{Ns::None, "hour"_L1, FeedScope::SkipHours, [](const FieldContext &ctx) {
+        bool ok = false;
+        const int hour = ctx.text.trimmed().toInt(&ok);
+        // RSS 2.0 uses 0 to 23, RSS 0.91 used 1 to 24
+        if (ok && hour >= 0 && hour <= 24) {
+            ctx.feed->skipHours.append(hour % 24);
+        }
+    }},
+    FeedField{Ns::Sy, "updatePeriod"_L1, FeedScope::Feed, [](const FieldContext &ctx) { ctx.feed->updatePeriod = syndicationPeriod(ctx.text); }},
+    FeedField{Ns::Sy, "updateFrequency"_L1, FeedScope::Feed, [](const FieldContext &ctx) { ctx.feed->updateFrequency = std::max(ctx.text.trimmed().toInt(), 1); }},
+    FeedField{Ns::Atom, "name"_L1, FeedScope::FeedAuthor, [](const FieldContext &ctx) {
+        if (ctx.feed->publisher.isEmpty()) {
+            ctx.feed->publisher = ctx.text.toString();
+        }
+    }},
+
+    // item/entry fields
+    FeedField{Ns::None, "title"_L1, FeedScope::Item, [](const FieldContext &ctx) { ctx.item->title = ctx.text.toString(); }},
+    FeedField{Ns::Rss10, "title"_L1, FeedScope::Item, [](const FieldContext &ctx) { ctx.item->title = ctx.text.toString(); }},
+    FeedField{Ns::Atom, "title"_L1, FeedScope::Item, [](const FieldContext &ctx) { ctx.item->title = ctx.text.toString(); }},
+    FeedField{Ns::None, "link"_L1, FeedScope::Item, [](const FieldContext &ctx) { ctx.item->link = QUrl(ctx.text.trimmed().toString()); }},
+    FeedField{Ns::Rss10, "link"_L1, FeedScope::Item, [](const FieldContext &ctx) { ctx.item->link = QUrl(ctx.text.trimmed().toString()); }},
+    FeedField{Ns::Atom, "link"_L1, FeedScope::Item, [](const FieldContext &ctx) {
+        if (ctx.attributes.value("rel"_L1) == "enclosure"_L1) {
+            if (isImageType(ctx.attributes)) {
+                setItemImage(ctx.item, ctx.attributes.value("href"_L1), ctx.attributes, Enclosure);
+            }
+        } else if (isAlternateLink(ctx.attributes) && ctx.item->link.isEmpty()) {
+            ctx.item->link = QUrl(ctx.attributes.value("href"_L1).toString());
+        }
+    }},
+    FeedField{Ns::None, "guid"_L1, FeedScope::Item, [](const FieldContext &ctx) { ctx.item->guid = ctx.text.trimmed().toString(); }},
+    FeedField{Ns::Atom, "id"_L1, FeedScope::Item, [](const FieldContext &ctx) { ctx.item->guid = ctx.text.trimmed().toString(); }},
+    FeedField{Ns::None, "description"_L1, FeedScope::Item, [](const FieldContext &ctx) { ctx.item->description = ctx.text.toString(); }},
+    FeedField{Ns::Rss10, "description"_L1, FeedScope::Item, [](const FieldContext &ctx) { ctx.item->description = ctx.text.toString(); }},
+    FeedField{Ns::Atom, "summary"_L1, FeedScope::Item, [](const FieldContext &ctx) { ctx.item->description = ctx.text.toString(); }},
+    FeedField{Ns::Atom, "content"_L1, FeedScope::Item, [](const FieldContext &ctx) {
+        if (ctx.item->description.isEmpty()) {
+            ctx.item->description = ctx.text.toString();
+        }
+        setItemImageFromHtml(ctx.item, ctx.text);
+    }},
+    FeedField{Ns::Content, "encoded"_L1, FeedScope::Item, [](const FieldContext &ctx) { setItemImageFromHtml(ctx.item, ctx.text); }},
+    FeedField{Ns::None, "enclosure"_L1, FeedScope::Item, [](const FieldContext &ctx) {
+        if (isImageType(ctx.attributes)) {
+            setItemImage(ctx.item, ctx.attributes.value("url"_L1), ctx.attributes, Enclosure);
+        }
+    }},
+    FeedField{Ns::Media, "content"_L1, FeedScope::Item, [](const FieldContext &ctx) {
+        if (ctx.attributes.value("medium"_L1) == "image"_L1 || isImageType(ctx.attributes)) {
+            setItemImage(ctx.item, ctx.attributes.value("url"_L1), ctx.attributes, Enclosure);
+        }
+    }},
+    FeedField{Ns::Media, "thumbnail"_L1, FeedScope::Item, [](const FieldContext &ctx) {
+        setItemImage(ctx.item, ctx.attributes.value("url"_L1), ctx.attributes, Thumbnail);
+    }},
+    FeedField{Ns::None, "author"_L1, FeedScope::Item, [](const FieldContext &ctx) { ctx.item->author = ctx.text.toString(); }},
+    FeedField{Ns::Dc, "creator"_L1, FeedScope::Item, [](const FieldContext &ctx) { ctx.item->author = ctx.text.toString(); }},
+    FeedField{Ns::Atom, "name"_L1, FeedScope::ItemAuthor, [](const FieldContext &ctx) {
+        if (ctx.item->author.isEmpty()) {
+            ctx.item->author = ctx.text.toString();
+        }
+    }},
+    FeedField{Ns::None, "pubDate"_L1, FeedScope::Item, [](const FieldContext &ctx) { ctx.item->pubDate = DateParser::parse(ctx.text); }},
+    FeedField{Ns::Dc, "date"_L1, FeedScope::Item, [](const FieldContext &ctx) { ctx.item->pubDate = DateParser::parse(ctx.text); }},
+    FeedField{Ns::Atom, "published"_L1, FeedScope::Item, [](const FieldContext &ctx) { ctx.item->pubDate = DateParser::parse(ctx.text); }},
+    FeedField{Ns::Atom, "updated"_L1, FeedScope::Item, [](const FieldContext &ctx) {
+        if (!ctx.item->pubDate.isValid()) {
+            ctx.item->pubDate = DateParser::parse(ctx.text);
+        }
+    }}
+};
+
+const FeedField *findField(Ns ns, QStringView name, FeedScope scope)
+{
+    for (const auto &field : feedFields) {
+        if (field.scope == scope && field.ns == ns && field.name == name) {
+            return &field;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
 FeedParser::FeedParser(QObject *parent)
     : QObject{parent}
 {
 
 }
 
-void FeedParser::parse(const QDomDocument &xml)
+void FeedParser::parse(QIODevice *device)
 {
-    const auto docEl = xml.documentElement();
-    const QString tagName = docEl.tagName();
-    if (tagName == "rss"_L1) {
-        auto version = QVersionNumber::fromString(docEl.attribute(u"version"_s));
-        if (version == QVersionNumber(2, 0)) {
-            parseRss2(xml);
-        } else {
-
+    m_device = device;
+    connect(device, &QIODevice::readyRead, this, [this]{
+        if (m_device) {
+            addData(m_device->readAll());
         }
-    } else if (tagName == "feed"_L1) {
+    });
+}
 
+void FeedParser::addData(const QByteArray &data)
+{
+    if (m_finished) {
+        return;
     }
+
+    m_hash.addData(data);
+
+    if (!m_error.isEmpty()) {
+        return;
+    }
+
+    m_reader.addData(data);
+    parseTokens();
 }
 
-void FeedParser::parseRss2(const QDomDocument &xml)
+void FeedParser::finish()
 {
-    const QDomNodeList channels = xml.elementsByTagName(u"channel"_s);
-    if (channels.size() != 1) {
-        emit feedParsed({});
+    if (m_finished) {
         return;
     }
 
-    const auto channel = channels.at(0).toElement();
-    if (!channel.hasChildNodes()) {
+    if (m_device && m_device->bytesAvailable() > 0) {
+        addData(m_device->readAll());
+    }
+
+    m_finished = true;
+
+    if (m_error.isEmpty() && m_reader.error() == QXmlStreamReader::PrematureEndOfDocumentError) {
+        m_error = m_reader.errorString();
+        m_errorLine = m_reader.lineNumber();
+        m_errorColumn = m_reader.columnNumber();
+    }
+
+    if (m_error.isEmpty()) {
+        if (m_feed.data->source.isEmpty()) {
+            m_feed.data->source = m_fallbackSource;
+        }
+        emit feedParsed(m_feed);
+    } else {
         emit feedParsed({});
-        return;
     }
+}
 
-    Feed feed;
-    feed.data->type = Feed::Type::RSS_2_0;
-    const auto nodes = channel.childNodes();
-    for (const auto &node : nodes) {
-        const auto e = node.toElement();
-        const QString tn = e.tagName();
-        if (tn == "title"_L1) {
-            feed.data->title = e.text();
-        } else if (tn == "description"_L1) {
-            feed.data->description = e.text();
-        } else if (tn == "link"_L1) {
-            if (e.attribute(u"rel"_s) == "self"_L1) {
-                feed.data->source = QUrl(e.attribute(u"href"_s));
-            } else if (e.attribute(u"rel"_s).isEmpty()) {
-                feed.data->link = QUrl(e.text());
-            }
-        } else if (tn == "lastBuildDate"_L1) {
-            feed.data->lastBuildDate = QDateTime::fromString(e.text(), Qt::RFC2822Date).toUTC();
-        } else if (tn == "generator"_L1) {
-            feed.data->generator = e.text();
-        } else if (tn == "langauge"_L1) {
-            feed.data->language = e.text();
-        } else if (tn == "managingDirector"_L1) {
-            feed.data->publisher = e.text();
-        } else if (tn == "item"_L1) {
-            if (e.hasChildNodes()) {
-                FeedItem item;
-                const auto itemNodes = e.childNodes();
-                for (const auto &iNode : itemNodes) {
-                    const auto ie = iNode.toElement();
-                    const QString itn = ie.tagName();
-                    if (itn == "title"_L1) {
-                        item.data->title = ie.text();
-                    } else if (itn == "link"_L1) {
-                        item.data->link = QUrl(ie.text());
-                    } else if (itn == "guid"_L1) {
-                        item.data->guid = ie.text();
-                    } else if (itn == "description"_L1) {
-                        item.data->description = ie.text();
-                    } else if (itn == "author"_L1 || itn == "creator"_L1) {
-                        item.data->author = ie.text();
-                    } else if (itn == "pubDate"_L1) {
-                        item.data->pubDate = QDateTime::fromString(ie.text(), Qt::RFC2822Date).toUTC();
-                    }
-                }
-                feed.data->items.emplace_back(std::move(item));
+void FeedParser::setFallbackSource(const QUrl &source)
+{
+    m_fallbackSource = source;
+}
+
+QByteArray FeedParser::contentHash() const
+{
+    return m_hash.result();
+}
+
+bool FeedParser::hasError() const noexcept
+{
+    return !m_error.isEmpty();
+}
+
+QString FeedParser::errorString() const
+{
+    return m_error;
+}
+
+qint64 FeedParser::errorLine() const noexcept
+{
+    return m_errorLine;
+}
+
+qint64 FeedParser::errorColumn() const noexcept
+{
+    return m_errorColumn;
+}
+
+void FeedParser::parseTokens()
+{
+    while (!m_reader.atEnd()) {
+        switch (m_reader.readNext()) {
+        case QXmlStreamReader::StartElement:
+            startElement();
+            break;
+        case QXmlStreamReader::EndElement:
+            endElement();
+            break;
+        case QXmlStreamReader::Characters:
+            if (m_captureDepth > 0) {
+                m_text.append(m_reader.text());
             }
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (m_reader.hasError() && m_reader.error() != QXmlStreamReader::PrematureEndOfDocumentError) {
+        m_error = m_reader.errorString();
+        m_errorLine = m_reader.lineNumber();
+        m_errorColumn = m_reader.columnNumber();
+    }
+}
+
+bool FeedParser::startRootElement()
+{
+    const auto ns = namespaceFromUri(m_reader.namespaceUri());
+    const auto name = m_reader.name();
+
+    if (ns == Ns::None && name == "rss"_L1) {
+        const auto version = QVersionNumber::fromString(m_reader.attributes().value("version"_L1));
+        if (version == QVersionNumber(0, 91)) {
+            m_feed.data->type = Feed::Type::RSS_0_91;
+        } else if (version == QVersionNumber(0, 92)) {
+            m_feed.data->type = Feed::Type::RSS_0_92;
+        } else if (version.majorVersion() == 2 || version == QVersionNumber(0, 93) || version == QVersionNumber(0, 94)) {
+            m_feed.data->type = Feed::Type::RSS_2_0;
+        } else {
+            return false;
+        }
+        m_stack.append({{}, nullptr, FeedScope::Root});
+    } else if (ns == Ns::Rdf && name == "RDF"_L1) {
+        m_feed.data->type = Feed::Type::RSS_1_0;
+        m_stack.append({{}, nullptr, FeedScope::Root});
+    } else if (ns == Ns::Atom && name == "feed"_L1) {
+        m_feed.data->type = Feed::Type::Atom_1_0;
+        m_stack.append({{}, nullptr, FeedScope::Feed});
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+void FeedParser::startElement()
+{
+    if (m_stack.empty()) {
+        if (!startRootElement()) {
+            m_reader.raiseError(u"Not supported feed format."_s);
+        }
+        return;
+    }
+
+    FeedScope scope = m_stack.last().childScope;
+
+    if (m_captureDepth > 0 || scope == FeedScope::Ignored) {
+        m_stack.append({{}, nullptr, FeedScope::Ignored});
+        return;
+    }
+
+    const auto ns = namespaceFromUri(m_reader.namespaceUri());
+    const auto name = m_reader.name();
+
+    // media groups only wrap the media elements of an item
+    if (scope == FeedScope::MediaGroup) {
+        scope = FeedScope::Item;
+    }
+
+    switch (scope) {
+    case FeedScope::Root:
+        if (name == "channel"_L1 && (ns == Ns::None || ns == Ns::Rss10)) {
+            m_stack.append({{}, nullptr, FeedScope::Feed});
+            return;
+        }
+        // RSS 1.0 has its items outside of the channel element
+        if (name == "item"_L1 && ns == Ns::Rss10) {
+            m_item = FeedItem();
+            m_item.data->guid = m_reader.attributes().value(u"http://www.w3.org/1999/02/22-rdf-syntax-ns#"_s, "about"_L1).toString();
+            m_stack.append({{}, nullptr, FeedScope::Item});
+            return;
+        }
+        break;
+    case FeedScope::Feed:
+        if ((name == "item"_L1 && ns == Ns::None) || (name == "entry"_L1 && ns == Ns::Atom)) {
+            m_item = FeedItem();
+            m_stack.append({{}, nullptr, FeedScope::Item});
+            return;
+        }
+        if (name == "author"_L1 && ns == Ns::Atom) {
+            m_stack.append({{}, nullptr, FeedScope::FeedAuthor});
+            return;
+        }
+        if (name == "skipHours"_L1 && ns == Ns::None) {
+            m_stack.append({{}, nullptr, FeedScope::SkipHours});
+            return;
         }
+        break;
+    case FeedScope::Item:
+        if (name == "author"_L1 && ns == Ns::Atom) {
+            m_stack.append({{}, nullptr, FeedScope::ItemAuthor});
+            return;
+        }
+        // media elements might be grouped, the group does not change the scope
+        if (name == "group"_L1 && ns == Ns::Media) {
+            m_stack.append({{}, nullptr, FeedScope::MediaGroup});
+            return;
+        }
+        break;
+    default:
+        break;
+    }
+
+    const FeedField *field = findField(ns, name, scope);
+    if (field) {
+        m_stack.append({m_reader.attributes(), field, FeedScope::Ignored});
+        m_captureDepth = m_stack.size();
+        m_text.clear();
+    } else {
+        m_stack.append({{}, nullptr, FeedScope::Ignored});
+    }
+}
+
+void FeedParser::endElement()
+{
+    if (m_stack.empty()) {
+        return;
     }
 
-    emit feedParsed(feed);
+    const Frame frame = m_stack.takeLast();
+
+    if (frame.field) {
+        frame.field->handle({m_feed.data.data(), m_item.data.data(), m_text, frame.attributes});
+        m_captureDepth = 0;
+        m_text.clear();
+    } else if (frame.childScope == FeedScope::Item) {
+        if (m_item.data->guid.isEmpty()) {
+            m_item.data->guid = m_item.data->link.toString();
+        }
+        m_feed.data->items.emplace_back(std::move(m_item));
+        m_item = FeedItem();
+    }
 }
+
+#include "moc_feedparser.cpp"
@@ -8,10 +8,27 @@
 
 #include "feed.h"
 
+#include <QCryptographicHash>
 #include <QObject>
+#include <QPointer>
+#include <QXmlStreamReader>
 
-class QDomDocument;
+class QIODevice;
+struct FeedField;
+enum class FeedScope : quint8;
 
+/*!
+ * \brief Incremental parser for web feeds.
+ *
+ * The parser is fed with chunks of data as they arrive, either by calling addData()
+ * or by attaching it to a QIODevice via parse(). Items are created directly from the
+ * XML tokens, so no document tree has to be kept in memory. After all data has been
+ * added, call finish() to get the parsed feed emitted via feedParsed().
+ *
+ * Supported formats are RSS 0.91, 0.92, 1.0 (RDF) and 2.0 as well as Atom 1.0.
+ * Elements are mapped to feed and item fields by a dispatch table that is keyed
+ * on the namespace and the local name of the element.
+ */
 class FeedParser : public QObject
 {
     Q_OBJECT
@@ -20,14 +37,73 @@ public:
     explicit FeedParser(QObject *parent = nullptr);
     ~FeedParser() override = default;
 
-public slots:
-    void parse(const QDomDocument &xml);
+    /*!
+     * \brief Reads data from \a device whenever it emits QIODevice::readyRead().
+     */
+    void parse(QIODevice *device);
+
+    /*!
+     * \brief Adds the next chunk of \a data and parses as much of it as possible.
+     */
+    void addData(const QByteArray &data);
+
+    /*!
+     * \brief Parses remaining data and emits feedParsed().
+     *
+     * If there was an error, the emitted feed will be invalid and hasError() will
+     * return \c true.
+     */
+    void finish();
+
+    /*!
+     * \brief Sets the \a source URL that will be used if the feed does not contain a self link.
+     */
+    void setFallbackSource(const QUrl &source);
+
+    /*!
+     * \brief Returns the hash over all data that has been added so far.
+     *
+     * The hash is also calculated for data that could not be parsed. It can be used to
+     * detect byte-identical responses.
+     */
+    [[nodiscard]] QByteArray contentHash() const;
+
+    [[nodiscard]] bool hasError() const noexcept;
 
-private slots:
-    void parseRss2(const QDomDocument &xml);
+    [[nodiscard]] QString errorString() const;
+
+    [[nodiscard]] qint64 errorLine() const noexcept;
+
+    [[nodiscard]] qint64 errorColumn() const noexcept;
 
 signals:
     void feedParsed(const Feed &feed);
+
+private:
+    struct Frame {
+        QXmlStreamAttributes attributes;
+        const FeedField *field{nullptr};
+        FeedScope childScope;
+    };
+
+    void parseTokens();
+    void startElement();
+    void endElement();
+    [[nodiscard]] bool startRootElement();
+
+    QXmlStreamReader m_reader;
+    QCryptographicHash m_hash{QCryptographicHash::Blake2b_160};
+    QPointer<QIODevice> m_device;
+    QList<Frame> m_stack;
+    Feed m_feed;
+    FeedItem m_item;
+    QUrl m_fallbackSource;
+    QString m_text;
+    QString m_error;
+    qint64 m_errorLine{0};
+    qint64 m_errorColumn{0};
+    qsizetype m_captureDepth{0};
+    bool m_finished{false};
 };
 
 #endif // HBNST_FEEDPARSER_H
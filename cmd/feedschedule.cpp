@@ -0,0 +1,99 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "feedschedule.h"
+#include "configuration.h"
+#include "confignames.h"
+#include "feed.h"
+
+#include <QTimeZone>
+
+#include <algorithm>
+
+namespace {
+// weight of the most recent gap between two items
+constexpr double emaAlpha = 0.3;
+}
+
+void FeedSchedule::loadConfig(const Configuration *config)
+{
+    const QString confSec = QStringLiteral(HBNST_CONF_FEEDS);
+    setMinInterval(std::chrono::minutes{config->value(confSec, QStringLiteral(HBNST_CONF_FEEDS_MININTERVAL), HBNST_CONF_FEEDS_MININTERVAL_DEFVAL).toInt()});
+    setMaxInterval(std::chrono::minutes{config->value(confSec, QStringLiteral(HBNST_CONF_FEEDS_MAXINTERVAL), HBNST_CONF_FEEDS_MAXINTERVAL_DEFVAL).toInt()});
+    setDefaultInterval(std::chrono::minutes{config->value(confSec, QStringLiteral(HBNST_CONF_FEEDS_UPDATEINTERVAL), HBNST_CONF_FEEDS_UPDATEINTERVAL_DEFVAL).toInt()});
+}
+
+QDateTime FeedSchedule::nextFetch(const QDateTime &now, QList<QDateTime> pubDates, const Feed &feed) const
+{
+    pubDates.removeIf([&now](const QDateTime &dt){
+        return !dt.isValid() || dt > now;
+    });
+    std::sort(pubDates.begin(), pubDates.end());
+    pubDates.erase(std::unique(pubDates.begin(), pubDates.end()), pubDates.end());
+
+    std::chrono::seconds interval = m_defaultInterval;
+
+    if (pubDates.size() > 1) {
+        // oldest gaps first, so the most recent ones have the highest weight
+        double ema = static_cast<double>(pubDates.at(0).secsTo(pubDates.at(1)));
+        for (qsizetype i = 2; i < pubDates.size(); ++i) {
+            ema = emaAlpha * static_cast<double>(pubDates.at(i - 1).secsTo(pubDates.at(i))) + (1.0 - emaAlpha) * ema;
+        }
+        // a long silence since the last item also counts as an observed gap
+        const auto silence = static_cast<double>(pubDates.last().secsTo(now));
+        if (silence > ema) {
+            ema = emaAlpha * silence + (1.0 - emaAlpha) * ema;
+        }
+        interval = std::chrono::seconds{static_cast<qint64>(ema)};
+    }
+
+    interval = std::clamp<std::chrono::seconds>(interval, m_minInterval, maxInterval());
+
+    // the publisher knows best, never poll more often than requested
+    interval = std::max<std::chrono::seconds>(interval, std::chrono::minutes{feed.ttl()});
+    interval = std::max(interval, feed.updateInterval());
+
+    QDateTime next = now.addDuration(interval);
+
+    const QList<int> skipHours = feed.skipHours();
+    if (!skipHours.empty() && skipHours.size() < 24) {
+        next = next.toUTC();
+        while (skipHours.contains(next.time().hour())) {
+            next = QDateTime(next.date(), QTime(next.time().hour(), 0), QTimeZone::UTC).addSecs(60 * 60);
+        }
+    }
+
+    return next;
+}
+
+void FeedSchedule::setMinInterval(std::chrono::minutes interval)
+{
+    m_minInterval = std::max(interval, std::chrono::minutes{1});
+}
+
+std::chrono::minutes FeedSchedule::minInterval() const noexcept
+{
+    return m_minInterval;
+}
+
+void FeedSchedule::setMaxInterval(std::chrono::minutes interval)
+{
+    m_maxInterval = std::max(interval, std::chrono::minutes{1});
+}
+
+std::chrono::minutes FeedSchedule::maxInterval() const noexcept
+{
+    return std::max(m_maxInterval, m_minInterval);
+}
+
+void FeedSchedule::setDefaultInterval(std::chrono::minutes interval)
+{
+    m_defaultInterval = std::max(interval, std::chrono::minutes{1});
+}
+
+std::chrono::minutes FeedSchedule::defaultInterval() const noexcept
+{
+    return m_defaultInterval;
+}
@@ -0,0 +1,60 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef HBNST_FEEDSCHEDULE_H
+#define HBNST_FEEDSCHEDULE_H
+
+#include <QDateTime>
+#include <QList>
+
+#include <chrono>
+
+class Configuration;
+class Feed;
+
+/*!
+ * \brief Calculates when a feed should be fetched the next time.
+ *
+ * The interval is derived from an exponential moving average of the time between
+ * the publication dates of the feed items and is bounded by minInterval() and
+ * maxInterval(). Feeds without enough history get the defaultInterval(). Hints
+ * published by the feed itself like the RSS \c ttl, \c skipHours and the update
+ * period of the syndication module are honored.
+ */
+class FeedSchedule
+{
+public:
+    FeedSchedule() = default;
+
+    /*!
+     * \brief Reads the intervals from the \c feeds section of the \a config.
+     */
+    void loadConfig(const Configuration *config);
+
+    /*!
+     * \brief Returns the next time the \a feed should be fetched.
+     *
+     * \a pubDates are the publication dates of the latest items of the feed in any order.
+     * \a feed might be invalid if it has not been parsed, in that case only \a pubDates
+     * are taken into account.
+     */
+    [[nodiscard]] QDateTime nextFetch(const QDateTime &now, QList<QDateTime> pubDates, const Feed &feed) const;
+
+    void setMinInterval(std::chrono::minutes interval);
+    [[nodiscard]] std::chrono::minutes minInterval() const noexcept;
+
+    void setMaxInterval(std::chrono::minutes interval);
+    [[nodiscard]] std::chrono::minutes maxInterval() const noexcept;
+
+    void setDefaultInterval(std::chrono::minutes interval);
+    [[nodiscard]] std::chrono::minutes defaultInterval() const noexcept;
+
+private:
+    std::chrono::minutes m_minInterval{15};
+    std::chrono::minutes m_maxInterval{24 * 60};
+    std::chrono::minutes m_defaultInterval{60};
+};
+
+#endif // HBNST_FEEDSCHEDULE_H
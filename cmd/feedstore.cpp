@@ -0,0 +1,104 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "feedstore.h"
+#include "configuration.h"
+#include "confignames.h"
+#include "itemstore.h"
+#include "utils.h"
+
+#include <QDateTime>
+#include <QJsonObject>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
+using namespace Qt::StringLiterals;
+
+FeedStore::FeedStore(const QString &connectionName)
+    : m_connectionName{connectionName}
+{
+
+}
+
+void FeedStore::loadConfig(const Configuration *config)
+{
+    m_maxDescriptionLength = config->value(QStringLiteral(HBNST_CONF_FEEDS), QStringLiteral(HBNST_CONF_FEEDS_DESCRIPTIONLENGTH), HBNST_CONF_FEEDS_DESCRIPTIONLENGTH_DEFVAL).toLongLong();
+}
+
+std::optional<int> FeedStore::insert(const NewFeed &newFeed)
+{
+    auto db = QSqlDatabase::database(m_connectionName);
+
+    if (Q_UNLIKELY(!db.transaction())) {
+        m_lastError = db.lastError();
+        return std::nullopt;
+    }
+
+    QSqlQuery q{db};
+
+    if (Q_UNLIKELY(!q.prepare(uR"-(INSERT INTO feeds ("placeId", slug, title, description, source, link, "lastBuildDate", "lastFetch", created, data, etag, "lastModified", "contentHash", "searchConfig")
+                              VALUES (:placeId, :slug, :title, :description, :source, :link, :lastBuildDate, :lastFetch, :created, :data, :etag, :lastModified, :contentHash, CAST(:searchConfig AS regconfig))
+                              ON CONFLICT (source) DO NOTHING
+                              RETURNING id)-"_s))) {
+        m_lastError = q.lastError();
+        db.rollback();
+        return std::nullopt;
+    }
+
+    const Feed &feed = newFeed.feed;
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+
+    q.bindValue(u":placeId"_s, newFeed.placeId);
+    q.bindValue(u":slug"_s, newFeed.slug);
+    q.bindValue(u":title"_s, newFeed.title);
+    q.bindValue(u":description"_s, newFeed.description);
+    q.bindValue(u":source"_s, feed.source());
+    q.bindValue(u":link"_s, feed.link());
+    q.bindValue(u":lastBuildDate"_s, feed.lastBuildDate());
+    q.bindValue(u":lastFetch"_s, now);
+    q.bindValue(u":created"_s, now);
+    q.bindValue(u":data"_s, QJsonObject());
+    q.bindValue(u":etag"_s, newFeed.etag.isEmpty() ? QVariant() : newFeed.etag);
+    q.bindValue(u":lastModified"_s, newFeed.lastModified.isEmpty() ? QVariant() : newFeed.lastModified);
+    q.bindValue(u":contentHash"_s, newFeed.contentHash);
+    q.bindValue(u":searchConfig"_s, Utils::searchConfig(feed.language()));
+
+    if (Q_UNLIKELY(!q.exec())) {
+        m_lastError = q.lastError();
+        db.rollback();
+        return std::nullopt;
+    }
+
+    if (!q.next()) {
+        // a feed with the same source already exists
+        db.rollback();
+        return 0;
+    }
+
+    const int feedId = q.value(0).toInt();
+
+    ItemStore store{m_connectionName};
+    store.setMaxDescriptionLength(m_maxDescriptionLength);
+    // skip the lookup of stored items, a new feed rarely shares items with stored ones
+    store.setCheckUnchanged(false);
+    if (Q_UNLIKELY(!store.upsert(feedId, feed.items()))) {
+        m_lastError = store.lastError();
+        db.rollback();
+        return std::nullopt;
+    }
+
+    if (Q_UNLIKELY(!db.commit())) {
+        m_lastError = db.lastError();
+        db.rollback();
+        return std::nullopt;
+    }
+
+    return feedId;
+}
+
+QSqlError FeedStore::lastError() const
+{
+    return m_lastError;
+}
@@ -0,0 +1,66 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef HBNST_FEEDSTORE_H
+#define HBNST_FEEDSTORE_H
+
+#include "feed.h"
+
+#include <QByteArray>
+#include <QSqlError>
+#include <QString>
+
+#include <optional>
+
+class Configuration;
+
+/*!
+ * \brief Writes new feeds together with their initial items to the database.
+ */
+class FeedStore
+{
+public:
+    struct NewFeed {
+        Feed feed;
+        QString slug;
+        QString title;
+        QString description;
+        QString etag;
+        QString lastModified;
+        QByteArray contentHash;
+        int placeId{0};
+    };
+
+    /*!
+     * \brief Constructs a new %FeedStore that uses the database connection identified by \a connectionName.
+     */
+    explicit FeedStore(const QString &connectionName);
+
+    /*!
+     * \brief Reads the settings for writing items from the \c feeds section of the \a config.
+     */
+    void loadConfig(const Configuration *config);
+
+    /*!
+     * \brief Inserts \a newFeed and all of its items inside a single transaction.
+     *
+     * Items are written with batched multi-row statements through ItemStore. Returns
+     * the database ID of the new feed or \c 0 if a feed with the same source already
+     * exists. Returns \c std::nullopt on error, use lastError() to get the error.
+     */
+    [[nodiscard]] std::optional<int> insert(const NewFeed &newFeed);
+
+    /*!
+     * \brief Returns the last database error.
+     */
+    [[nodiscard]] QSqlError lastError() const;
+
+private:
+    QString m_connectionName;
+    QSqlError m_lastError;
+    qsizetype m_maxDescriptionLength{0};
+};
+
+#endif // HBNST_FEEDSTORE_H
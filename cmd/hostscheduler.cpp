@@ -0,0 +1,115 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "hostscheduler.h"
+#include "configuration.h"
+#include "confignames.h"
+
+#include <QCoreApplication>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QTimer>
+
+#include <algorithm>
+
+using namespace Qt::StringLiterals;
+
+HostScheduler::HostScheduler(QObject *parent)
+    : QObject{parent}
+    , m_nam{new QNetworkAccessManager(this)}
+{
+#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
+    m_nam->setTransferTimeout(std::chrono::seconds{10});
+#else
+    m_nam->setTransferTimeout(10'000);
+#endif
+}
+
+void HostScheduler::loadConfig(const Configuration *config)
+{
+    const QString confSec = QStringLiteral(HBNST_CONF_FEEDS);
+    setMaxConnectionsPerHost(config->value(confSec, QStringLiteral(HBNST_CONF_FEEDS_HOSTCONNECTIONS), HBNST_CONF_FEEDS_HOSTCONNECTIONS_DEFVAL).toInt());
+    setHostDelay(std::chrono::milliseconds{config->value(confSec, QStringLiteral(HBNST_CONF_FEEDS_HOSTDELAY), HBNST_CONF_FEEDS_HOSTDELAY_DEFVAL).toInt()});
+}
+
+void HostScheduler::get(const QNetworkRequest &request, QObject *context, const StartedCallback &started)
+{
+    QNetworkRequest req{request};
+    if (!req.header(QNetworkRequest::UserAgentHeader).isValid()) {
+        req.setHeader(QNetworkRequest::UserAgentHeader, QString(QCoreApplication::applicationName() + '/'_L1 + QCoreApplication::applicationVersion()));
+    }
+
+    const QUrl url = req.url();
+    const QString hostKey = url.scheme() + "://"_L1 + url.host().toLower() + ':'_L1 + QString::number(url.port());
+
+    m_hosts[hostKey].queue.enqueue({req, context, started});
+    dispatch(hostKey);
+}
+
+void HostScheduler::dispatch(const QString &hostKey)
+{
+    for (;;) {
+        // look the host up on every iteration, the started callback might enqueue new requests
+        auto &host = m_hosts[hostKey];
+
+        if (host.queue.empty() || host.running >= m_maxConnectionsPerHost || host.timerActive) {
+            return;
+        }
+
+        if (host.lastStart.isValid() && m_hostDelay.count() > 0) {
+            const std::chrono::milliseconds elapsed{host.lastStart.elapsed()};
+            if (elapsed < m_hostDelay) {
+                host.timerActive = true;
+                QTimer::singleShot(m_hostDelay - elapsed, this, [this, hostKey]{
+                    m_hosts[hostKey].timerActive = false;
+                    dispatch(hostKey);
+                });
+                return;
+            }
+        }
+
+        const PendingRequest pending = host.queue.dequeue();
+        if (pending.context.isNull()) {
+            continue;
+        }
+
+        ++host.running;
+        host.lastStart.start();
+
+        auto reply = m_nam->get(pending.request);
+        connect(reply, &QNetworkReply::finished, this, [this, hostKey]{
+            --m_hosts[hostKey].running;
+            dispatch(hostKey);
+        });
+        pending.started(reply);
+    }
+}
+
+void HostScheduler::setMaxConnectionsPerHost(int max)
+{
+    m_maxConnectionsPerHost = std::max(max, 1);
+}
+
+int HostScheduler::maxConnectionsPerHost() const noexcept
+{
+    return m_maxConnectionsPerHost;
+}
+
+void HostScheduler::setHostDelay(std::chrono::milliseconds delay)
+{
+    m_hostDelay = std::max(delay, std::chrono::milliseconds{0});
+}
+
+std::chrono::milliseconds HostScheduler::hostDelay() const noexcept
+{
+    return m_hostDelay;
+}
+
+QNetworkAccessManager *HostScheduler::networkAccessManager() const noexcept
+{
+    return m_nam;
+}
+
+#include "moc_hostscheduler.cpp"
@@ -0,0 +1,88 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef HBNST_HOSTSCHEDULER_H
+#define HBNST_HOSTSCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QNetworkRequest>
+#include <QObject>
+#include <QPointer>
+#include <QQueue>
+
+#include <chrono>
+#include <functional>
+
+class Configuration;
+class QNetworkAccessManager;
+class QNetworkReply;
+
+/*!
+ * \brief Schedules network requests per host.
+ *
+ * Requests are queued per host. Only a limited number of requests per host will run
+ * at the same time and new requests to the same host are only started after a minimum
+ * delay. Requests to different hosts run in parallel. All requests share the same
+ * QNetworkAccessManager, so connections to the same host can be reused.
+ */
+class HostScheduler : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(HostScheduler)
+public:
+    using StartedCallback = std::function<void(QNetworkReply *reply)>;
+
+    /*!
+     * \brief Constructs a new %HostScheduler object with the given \a parent.
+     */
+    explicit HostScheduler(QObject *parent = nullptr);
+
+    ~HostScheduler() override = default;
+
+    /*!
+     * \brief Reads the per host limits from the \c feeds section of the \a config.
+     */
+    void loadConfig(const Configuration *config);
+
+    /*!
+     * \brief Enqueues a GET \a request.
+     *
+     * \a started will be called with the QNetworkReply as soon as the request has been
+     * started. If \a context has been destroyed before, the request will be dropped.
+     */
+    void get(const QNetworkRequest &request, QObject *context, const StartedCallback &started);
+
+    void setMaxConnectionsPerHost(int max);
+    [[nodiscard]] int maxConnectionsPerHost() const noexcept;
+
+    void setHostDelay(std::chrono::milliseconds delay);
+    [[nodiscard]] std::chrono::milliseconds hostDelay() const noexcept;
+
+    [[nodiscard]] QNetworkAccessManager *networkAccessManager() const noexcept;
+
+private:
+    struct PendingRequest {
+        QNetworkRequest request;
+        QPointer<QObject> context;
+        StartedCallback started;
+    };
+
+    struct Host {
+        QQueue<PendingRequest> queue;
+        QElapsedTimer lastStart;
+        int running{0};
+        bool timerActive{false};
+    };
+
+    void dispatch(const QString &hostKey);
+
+    QHash<QString,Host> m_hosts;
+    QNetworkAccessManager *m_nam{nullptr};
+    std::chrono::milliseconds m_hostDelay{0};
+    int m_maxConnectionsPerHost{2};
+};
+
+#endif // HBNST_HOSTSCHEDULER_H
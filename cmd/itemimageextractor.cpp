@@ -4,97 +4,239 @@
  */
 
 #include "itemimageextractor.h"
+#include "configuration.h"
+#include "confignames.h"
+#include "hostscheduler.h"
+#include "logging.h"
+#include "opengraphscanner.h"
+#include "utils.h"
 
+#include <QDebug>
 #include <QMetaObject>
-#include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QNetworkRequest>
-#include <QRegularExpression>
-#include <QRegularExpressionMatch>
-#include <QUrl>
 
-using namespace Qt::StringLiterals;
+#include <algorithm>
+#include <memory>
 
-const QRegularExpression ItemImageExtractor::ogImgRegex{uR"-(<meta\s+property=["'](og:image[^"']*)["']\s+content=["']([^"']+))-"_s};
+using namespace Qt::StringLiterals;
 
-ItemImageExtractor::ItemImageExtractor(QObject *parent)
+ItemImageExtractor::ItemImageExtractor(HostScheduler *scheduler, QObject *parent)
     : QObject{parent}
+    , m_scheduler{scheduler}
 {
 
 }
 
+void ItemImageExtractor::loadConfig(const Configuration *config)
+{
+    const QString confSec = QStringLiteral(HBNST_CONF_FEEDS);
+    setConcurrency(config->value(confSec, QStringLiteral(HBNST_CONF_FEEDS_IMAGECONCURRENCY), HBNST_CONF_FEEDS_IMAGECONCURRENCY_DEFVAL).toInt());
+    setMaxScanBytes(config->value(confSec, QStringLiteral(HBNST_CONF_FEEDS_IMAGESCANBYTES), HBNST_CONF_FEEDS_IMAGESCANBYTES_DEFVAL).toLongLong());
+    setCacheTtl(std::chrono::minutes{config->value(confSec, QStringLiteral(HBNST_CONF_FEEDS_IMAGECACHETTL), HBNST_CONF_FEEDS_IMAGECACHETTL_DEFVAL).toInt()});
+}
+
 void ItemImageExtractor::start(const QList<FeedItem> &items)
 {
-    if (items.empty()) {
-        emit finished(m_itemImages, {});
+    for (const auto &item : items) {
+        // no need to fetch the page if the feed already contains an image
+        const QVariantMap image = item.image();
+        if (!image.empty()) {
+            m_itemImages.insert(item.guid(), image);
+            ++m_imagesFromFeed;
+            continue;
+        }
+
+        const QUrl link = item.link();
+        if (!link.isValid() || link.isRelative()) {
+            continue;
+        }
+
+        // items that are syndicated in multiple feeds often share the same link
+        const QString key = Utils::normalizeUrl(link);
+        auto &page = m_pages[key];
+        if (page.guids.empty()) {
+            page.url = link;
+            m_queue.enqueue(key);
+        }
+        page.guids << item.guid();
     }
 
-    for (const auto &item : items) {
-        m_items.enqueue(item);
+    if (!m_cacheConnectionName.isEmpty() && !m_queue.empty()) {
+        OpenGraphCache cache{m_cacheConnectionName};
+        const auto cached = cache.lookup(m_queue);
+        if (Q_UNLIKELY(cache.lastError().isValid())) {
+            qCWarning(ST_UPDATER).noquote() << "Failed to query OpenGraph cache:" << cache.lastError().text();
+        }
+
+        const QDateTime now = QDateTime::currentDateTimeUtc();
+        QQueue<QString> queue;
+        for (const QString &key : std::as_const(m_queue)) {
+            const auto it = cached.constFind(key);
+            if (it != cached.constEnd()) {
+                auto &page = m_pages[key];
+                page.cached = it.value();
+                page.isCached = true;
+                if (it->fetchedAt.isValid() && it->fetchedAt.toUTC().addDuration(m_cacheTtl) > now) {
+                    setPageImage(page, it->image);
+                    ++m_cacheHits;
+                    continue;
+                }
+            }
+            queue.enqueue(key);
+        }
+        m_queue = queue;
     }
 
-    m_nam = new QNetworkAccessManager(this);
-    m_nam->setTransferTimeout(10'000);
-    connect(m_nam, &QNetworkAccessManager::finished, this, &ItemImageExtractor::itemDataFetched);
+    QMetaObject::invokeMethod(this, "extract", Qt::QueuedConnection);
+}
+
+void ItemImageExtractor::setConcurrency(int concurrency)
+{
+    m_concurrency = std::max(concurrency, 1);
+}
+
+int ItemImageExtractor::concurrency() const noexcept
+{
+    return m_concurrency;
+}
+
+void ItemImageExtractor::setMaxScanBytes(qsizetype maxBytes)
+{
+    m_maxScanBytes = std::max<qsizetype>(maxBytes, 0);
+}
+
+qsizetype ItemImageExtractor::maxScanBytes() const noexcept
+{
+    return m_maxScanBytes;
+}
+
+void ItemImageExtractor::setCacheConnectionName(const QString &connectionName)
+{
+    m_cacheConnectionName = connectionName;
+}
+
+void ItemImageExtractor::setCacheTtl(std::chrono::minutes ttl)
+{
+    m_cacheTtl = std::max(ttl, std::chrono::minutes{0});
+}
+
+std::chrono::minutes ItemImageExtractor::cacheTtl() const noexcept
+{
+    return m_cacheTtl;
+}
+
+int ItemImageExtractor::imagesFromFeed() const noexcept
+{
+    return m_imagesFromFeed;
+}
+
+int ItemImageExtractor::pagesScraped() const noexcept
+{
+    return m_pagesScraped;
+}
 
-    QMetaObject::invokeMethod(this, "extract");
+int ItemImageExtractor::cacheHits() const noexcept
+{
+    return m_cacheHits;
 }
 
 void ItemImageExtractor::extract()
 {
-    if (m_items.empty()) {
+    if (m_queue.empty() && m_running == 0) {
+        if (!m_cacheConnectionName.isEmpty()) {
+            OpenGraphCache cache{m_cacheConnectionName};
+            if (Q_UNLIKELY(!cache.store(m_cacheUpdates))) {
+                qCWarning(ST_UPDATER).noquote() << "Failed to update OpenGraph cache:" << cache.lastError().text();
+            }
+        }
         deleteLater();
         emit finished(m_itemImages, m_errors);
         return;
     }
 
-    m_currentItem = m_items.dequeue();
+    while (m_running < m_concurrency && !m_queue.empty()) {
+        const QString key = m_queue.dequeue();
+        const Page &page = m_pages[key];
+        ++m_running;
+        ++m_pagesScraped;
 
-    QNetworkRequest req{m_currentItem.link()};
-    m_nam->get(req);
-}
+        QNetworkRequest req{page.url};
+        if (page.isCached) {
+            if (!page.cached.etag.isEmpty()) {
+                req.setRawHeader("If-None-Match"_ba, page.cached.etag.toLatin1());
+            }
+            if (!page.cached.lastModified.isEmpty()) {
+                req.setRawHeader("If-Modified-Since"_ba, page.cached.lastModified.toLatin1());
+            }
+        }
 
-void ItemImageExtractor::itemDataFetched(QNetworkReply *reply)
-{
-    if (reply->error() != QNetworkReply::NoError) {
-        m_errors.insert(m_currentItem.guid(), reply->errorString());
-    } else {
-        QVariantMap map;
-        const QString data = QString::fromUtf8(reply->readAll());
-        for (const auto &match : ogImgRegex.globalMatch(data)) {
-            const QString property = match.captured(1);
-            const QString content = match.captured(2);
-            if (property == "og:image"_L1) {
-                QUrl url{content};
-                if (url.isValid()) {
-                    map.insert(u"url"_s, url);
-                }
-            } else if (property == "og:image:secure_url"_L1) {
-                QUrl url{content};
-                if (url.isValid()) {
-                    map.insert(u"secure_url"_s, url);
-                }
-            } else if (property == "og:image:width"_L1) {
-                bool ok{false};
-                const int width = content.toInt(&ok);
-                if (ok) {
-                    map.insert(u"width"_s, width);
+        m_scheduler->get(req, this, [this, key](QNetworkReply *reply){
+            // OpenGraph data is in the head, so the page is scanned while it is downloaded
+            // and the download is aborted as soon as the head has been read
+            auto scanner = std::make_shared<OpenGraphScanner>(m_maxScanBytes);
+            auto aborted = std::make_shared<bool>(false);
+            connect(reply, &QNetworkReply::readyRead, this, [reply, scanner, aborted]{
+                if (!scanner->isDone() && scanner->addData(reply->readAll())) {
+                    *aborted = true;
+                    QMetaObject::invokeMethod(reply, &QNetworkReply::abort, Qt::QueuedConnection);
                 }
-            } else if (property == "og:image:height"_L1) {
-                bool ok{false};
-                const int height = content.toInt(&ok);
-                if (ok) {
-                    map.insert(u"height"_s, height);
+            });
+            connect(reply, &QNetworkReply::finished, this, [this, key, reply, scanner, aborted]{
+                if (!scanner->isDone()) {
+                    scanner->addData(reply->readAll());
                 }
-            } else if (property == "og:image:alt"_L1) {
-                map.insert(u"alt"_s, content);
-            } else if (property == "og:image:type"_L1) {
-                map.insert(u"type"_s, content);
-            }
+                pageFetched(key, reply, *scanner, *aborted);
+            });
+        });
+    }
+}
+
+void ItemImageExtractor::pageFetched(const QString &key, QNetworkReply *reply, const OpenGraphScanner &scanner, bool abortedByUs)
+{
+    reply->deleteLater();
+    --m_running;
+
+    const Page page = m_pages.value(key);
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    const int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+    // error pages often contain a complete head, so a finished scan alone does not mean success,
+    // replies aborted by us after the head has been read are only fine with a 2xx status
+    const bool succeeded = reply->error() == QNetworkReply::NoError || (abortedByUs && statusCode >= 200 && statusCode < 300);
+
+    if (page.isCached && statusCode == 304) {
+        OpenGraphCache::Entry entry = page.cached;
+        entry.fetchedAt = now;
+        m_cacheUpdates.insert(key, entry);
+        setPageImage(page, entry.image);
+    } else if (!succeeded) {
+        // the error of a reply aborted by us would only say that the operation has been canceled
+        const QString error = abortedByUs
+                ? u"HTTP %1 %2"_s.arg(QString::number(statusCode), QString::fromLatin1(reply->attribute(QNetworkRequest::HttpReasonPhraseAttribute).toByteArray()))
+                : reply->errorString();
+        for (const QString &guid : page.guids) {
+            m_errors.insert(guid, error);
         }
-        m_itemImages.insert(m_currentItem.guid(), map);
+    } else {
+        const QVariantMap image = scanner.image();
+        m_cacheUpdates.insert(key, {
+                                  image,
+                                  now,
+                                  QString::fromLatin1(reply->rawHeader("ETag"_ba)),
+                                  QString::fromLatin1(reply->rawHeader("Last-Modified"_ba))
+                              });
+        setPageImage(page, image);
     }
+
     extract();
 }
 
+void ItemImageExtractor::setPageImage(const Page &page, const QVariantMap &image)
+{
+    for (const QString &guid : page.guids) {
+        m_itemImages.insert(guid, image);
+    }
+}
+
 #include "moc_itemimageextractor.cpp"
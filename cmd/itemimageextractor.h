@@ -7,38 +7,113 @@
 #define HBNST_ITEMIMAGEEXTRACTOR_H
 
 #include "feed.h"
+#include "opengraphcache.h"
 
+#include <QHash>
 #include <QObject>
 #include <QQueue>
 
-class QNetworkAccessManager;
+#include <chrono>
+
+class Configuration;
+class HostScheduler;
+class OpenGraphScanner;
 class QNetworkReply;
 
+/*!
+ * \brief Extracts OpenGraph image data from the web pages of feed items.
+ *
+ * Up to concurrency() pages are fetched at the same time. The requests are
+ * started through the HostScheduler, so the per host limits still apply. Pages
+ * are scanned while they are downloaded and the download is aborted after the
+ * head element or after maxScanBytes().
+ *
+ * Items that share the same normalized link are only fetched once. If a cache
+ * connection has been set, results are stored in the OpenGraphCache. Pages that
+ * have been fetched within cacheTtl() are not requested again, older entries are
+ * refreshed with conditional requests.
+ */
 class ItemImageExtractor : public QObject
 {
     Q_OBJECT
     Q_DISABLE_COPY(ItemImageExtractor)
 public:
-    explicit ItemImageExtractor(QObject *parent = nullptr);
+    explicit ItemImageExtractor(HostScheduler *scheduler, QObject *parent = nullptr);
     ~ItemImageExtractor() override = default;
 
 public:
+    /*!
+     * \brief Reads the concurrency, scan and cache limits from the \c feeds section of the \a config.
+     */
+    void loadConfig(const Configuration *config);
+
     void start(const QList<FeedItem> &items);
 
-private slots:
-    void extract();
-    void itemDataFetched(QNetworkReply *reply);
+    void setConcurrency(int concurrency);
+    [[nodiscard]] int concurrency() const noexcept;
+
+    /*!
+     * \brief Sets the maximum number of bytes per page that will be scanned.
+     *
+     * \c 0 means no limit.
+     */
+    void setMaxScanBytes(qsizetype maxBytes);
+    [[nodiscard]] qsizetype maxScanBytes() const noexcept;
+
+    /*!
+     * \brief Enables the OpenGraph cache using the database connection identified by \a connectionName.
+     */
+    void setCacheConnectionName(const QString &connectionName);
+
+    void setCacheTtl(std::chrono::minutes ttl);
+    [[nodiscard]] std::chrono::minutes cacheTtl() const noexcept;
+
+    /*!
+     * \brief Returns the number of items whose image has been taken from the feed itself.
+     */
+    [[nodiscard]] int imagesFromFeed() const noexcept;
+
+    /*!
+     * \brief Returns the number of item pages that had to be fetched.
+     */
+    [[nodiscard]] int pagesScraped() const noexcept;
+
+    /*!
+     * \brief Returns the number of item pages that have been taken from the cache without a request.
+     */
+    [[nodiscard]] int cacheHits() const noexcept;
 
 signals:
     void finished(const QVariantMap &itemImages, const QMap<QString,QString> &errors);
 
+private slots:
+    void extract();
+
 private:
-    FeedItem m_currentItem;
-    QQueue<FeedItem> m_items;
+    struct Page {
+        QUrl url;
+        QStringList guids;
+        OpenGraphCache::Entry cached;
+        bool isCached{false};
+    };
+
+    void pageFetched(const QString &key, QNetworkReply *reply, const OpenGraphScanner &scanner, bool abortedByUs);
+    void setPageImage(const Page &page, const QVariantMap &image);
+
+    QHash<QString,Page> m_pages;
+    QQueue<QString> m_queue;
+    QHash<QString,OpenGraphCache::Entry> m_cacheUpdates;
     QVariantMap m_itemImages;
     QMap<QString,QString> m_errors;
-    QNetworkAccessManager *m_nam{nullptr};
-    static const QRegularExpression ogImgRegex;
+    QString m_cacheConnectionName;
+    HostScheduler *m_scheduler{nullptr};
+    std::chrono::minutes m_cacheTtl{7 * 24 * 60};
+    int m_concurrency{4};
+    qsizetype m_maxScanBytes{256 * 1024};
+    int m_running{0};
+    int m_imagesFromFeed{0};
+    int m_pagesScraped{0};
+    int m_cacheHits{0};
 };
 
 #endif // HBNST_ITEMIMAGEEXTRACTOR_H
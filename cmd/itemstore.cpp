@@ -0,0 +1,498 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "itemstore.h"
+#include "configuration.h"
+#include "confignames.h"
+#include "logging.h"
+#include "utils.h"
+
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSqlDatabase>
+#include <QSet>
+#include <QSqlQuery>
+#include <QStringList>
+
+#ifdef WITH_LIBPQ
+#include <QSqlDriver>
+#include <QtEndian>
+#include <libpq-fe.h>
+#endif
+
+#include <algorithm>
+
+#if defined(QT_DEBUG)
+Q_LOGGING_CATEGORY(ST_ITEMS, "statalih.items");
+#else
+Q_LOGGING_CATEGORY(ST_ITEMS, "statalih.items", QtInfoMsg);
+#endif
+
+using namespace Qt::StringLiterals;
+
+namespace {
+
+// column sizes of the items table, see M0003_CreateItemsTable
+constexpr qsizetype maxGuidLength{2048};
+constexpr qsizetype maxTitleLength{255};
+constexpr qsizetype maxAuthorLength{255};
+constexpr qsizetype maxLinkLength{2048};
+
+/*!
+ * \brief Returns \a str truncated to at most \a maxLength characters without splitting surrogate pairs.
+ */
+QString clamped(const QString &str, qsizetype maxLength)
+{
+    if (str.size() <= maxLength) {
+        return str;
+    }
+    const qsizetype cut = str.at(maxLength - 1).isHighSurrogate() ? maxLength - 1 : maxLength;
+    return str.left(cut);
+}
+
+/*!
+ * \brief Returns the link of \a item truncated to the column size or a null string if there is no link.
+ */
+QString linkValue(const FeedItem &item)
+{
+    return item.link().isEmpty() ? QString() : clamped(item.link().toString(), maxLinkLength);
+}
+
+const QString upsertConflictClause = uR"-( ON CONFLICT (guid) DO UPDATE SET title = excluded.title, description = excluded.description, author = excluded.author, link = excluded.link, "pubDate" = excluded."pubDate"
+                                           WHERE excluded."pubDate" > items."pubDate"
+                                           RETURNING id, guid, (xmax = 0) AS inserted)-"_s;
+
+void collectUpserted(QSqlQuery &q, const QHash<QString,FeedItem> &itemsByGuid, QList<FeedItem> *newItems, QList<FeedItem> *updatedItems)
+{
+    while (q.next()) {
+        const FeedItem item = itemsByGuid.value(q.value(1).toString());
+        if (q.value(2).toBool()) {
+            if (newItems) {
+                *newItems << item;
+            }
+        } else {
+            if (updatedItems) {
+                *updatedItems << item;
+            }
+        }
+    }
+}
+
+#ifdef WITH_LIBPQ
+/*!
+ * \brief Writes rows in the binary format of the PostgreSQL \c COPY command.
+ */
+class CopyWriter
+{
+public:
+    explicit CopyWriter(PGconn *conn) : m_conn{conn}
+    {
+        m_buffer.reserve(bufferSize + 4096);
+        m_buffer.append("PGCOPY\n\377\r\n\0", 11);
+        appendInt<qint32>(0); // flags
+        appendInt<qint32>(0); // header extension length
+    }
+
+    void startRow(qint16 columns)
+    {
+        appendInt(columns);
+    }
+
+    void addText(const QString &text)
+    {
+        if (text.isNull()) {
+            appendInt<qint32>(-1);
+            return;
+        }
+        const QByteArray utf8 = text.toUtf8();
+        appendInt<qint32>(static_cast<qint32>(utf8.size()));
+        m_buffer.append(utf8);
+    }
+
+    void addTimestamp(const QDateTime &dt)
+    {
+        if (!dt.isValid()) {
+            appendInt<qint32>(-1);
+            return;
+        }
+        // microseconds since 2000-01-01 00:00:00 UTC
+        constexpr qint64 pgEpochOffset{946'684'800'000};
+        appendInt<qint32>(8);
+        appendInt<qint64>((dt.toMSecsSinceEpoch() - pgEpochOffset) * 1000);
+    }
+
+    bool endRow()
+    {
+        if (m_buffer.size() < bufferSize) {
+            return true;
+        }
+        return flush();
+    }
+
+    bool finish()
+    {
+        appendInt<qint16>(-1);
+        return flush() && PQputCopyEnd(m_conn, nullptr) == 1;
+    }
+
+private:
+    template<typename T>
+    void appendInt(T value)
+    {
+        const T be = qToBigEndian(value);
+        m_buffer.append(reinterpret_cast<const char *>(&be), sizeof(T));
+    }
+
+    bool flush()
+    {
+        const bool ok = PQputCopyData(m_conn, m_buffer.constData(), static_cast<int>(m_buffer.size())) == 1;
+        m_buffer.truncate(0);
+        return ok;
+    }
+
+    static constexpr qsizetype bufferSize{64 * 1024};
+
+    QByteArray m_buffer;
+    PGconn *m_conn{nullptr};
+};
+
+QSqlError libpqError(PGconn *conn, const QString &driverText)
+{
+    return QSqlError{driverText, QString::fromUtf8(PQerrorMessage(conn)), QSqlError::StatementError};
+}
+
+/*!
+ * \brief Reads the pending results and returns \c false if one of them has failed.
+ *
+ * Stops at the first result that is not \c PGRES_COMMAND_OK. A connection that is still
+ * in \c COPY_IN state would return the same result on every call.
+ */
+bool finishCommand(PGconn *conn)
+{
+    while (PGresult *res = PQgetResult(conn)) {
+        const ExecStatusType status = PQresultStatus(res);
+        PQclear(res);
+        if (status != PGRES_COMMAND_OK) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * \brief Ends a failed \c COPY and discards its results.
+ */
+void abortCopy(PGconn *conn)
+{
+    PQputCopyEnd(conn, "aborted");
+    finishCommand(conn);
+}
+#endif
+
+} // namespace
+
+ItemStore::ItemStore(const QString &connectionName)
+    : m_connectionName{connectionName}
+{
+
+}
+
+void ItemStore::loadConfig(const Configuration *config)
+{
+    setMaxDescriptionLength(config->value(QStringLiteral(HBNST_CONF_FEEDS), QStringLiteral(HBNST_CONF_FEEDS_DESCRIPTIONLENGTH), HBNST_CONF_FEEDS_DESCRIPTIONLENGTH_DEFVAL).toLongLong());
+}
+
+void ItemStore::setMaxDescriptionLength(qsizetype maxLength)
+{
+    m_maxDescriptionLength = std::max<qsizetype>(maxLength, 0);
+}
+
+void ItemStore::setCheckUnchanged(bool check)
+{
+    m_checkUnchanged = check;
+}
+
+void ItemStore::setMinRowsForCopy(qsizetype minRows)
+{
+    m_minRowsForCopy = std::max<qsizetype>(minRows, 1);
+}
+
+bool ItemStore::upsert(int feedId, const QList<FeedItem> &items, QList<FeedItem> *newItems, QList<FeedItem> *updatedItems)
+{
+    // ON CONFLICT DO UPDATE can not affect the same row twice in one statement,
+    // so only the first item with the same guid will be used
+    QHash<QString,FeedItem> itemsByGuid;
+    QList<FeedItem> uniqueItems;
+    uniqueItems.reserve(items.size());
+    for (const auto &item : items) {
+        if (item.guid().isEmpty() || itemsByGuid.contains(item.guid())) {
+            continue;
+        }
+        // other too long values are truncated, but a truncated guid could match a different item
+        if (Q_UNLIKELY(item.guid().size() > maxGuidLength)) {
+            qCWarning(ST_ITEMS).noquote().nospace() << "Skipping item with guid “" << item.guid().left(64) << "…” that is longer than "
+                                                    << maxGuidLength << " characters";
+            continue;
+        }
+        itemsByGuid.insert(item.guid(), item);
+        uniqueItems << item;
+    }
+
+    if (m_checkUnchanged && !removeUnchanged(uniqueItems)) {
+        return false;
+    }
+
+#ifdef WITH_LIBPQ
+    if (uniqueItems.size() >= m_minRowsForCopy && QSqlDatabase::database(m_connectionName).driverName() == "QPSQL"_L1) {
+        return copyUpsert(feedId, uniqueItems, itemsByGuid, newItems, updatedItems);
+    }
+#endif
+
+    QSqlQuery q{QSqlDatabase::database(m_connectionName)};
+
+    for (qsizetype offset = 0; offset < uniqueItems.size(); offset += maxRowsPerStatement) {
+        const auto batch = uniqueItems.sliced(offset, std::min(maxRowsPerStatement, uniqueItems.size() - offset));
+
+        QStringList values;
+        values.reserve(batch.size());
+        for (qsizetype i = 0; i < batch.size(); ++i) {
+            values << u"(?, ?, ?, ?, ?, ?, ?)"_s;
+        }
+
+        const QString qs = uR"-(INSERT INTO items ("feedId", guid, title, description, author, link, "pubDate") VALUES )-"_s
+                + values.join(", "_L1)
+                + upsertConflictClause;
+
+        if (Q_UNLIKELY(!q.prepare(qs))) {
+            m_lastError = q.lastError();
+            return false;
+        }
+
+        for (const auto &item : batch) {
+            q.addBindValue(feedId);
+            q.addBindValue(item.guid());
+            q.addBindValue(clamped(item.title(), maxTitleLength));
+            q.addBindValue(Utils::cleanDescription(item.description(), m_maxDescriptionLength));
+            q.addBindValue(clamped(item.author(), maxAuthorLength));
+            q.addBindValue(linkValue(item));
+            q.addBindValue(item.pubDate());
+        }
+
+        if (Q_UNLIKELY(!q.exec())) {
+            m_lastError = q.lastError();
+            return false;
+        }
+
+        collectUpserted(q, itemsByGuid, newItems, updatedItems);
+    }
+
+    return true;
+}
+
+#ifdef WITH_LIBPQ
+bool ItemStore::copyUpsert(int feedId, const QList<FeedItem> &items, const QHash<QString,FeedItem> &itemsByGuid, QList<FeedItem> *newItems, QList<FeedItem> *updatedItems)
+{
+    auto db = QSqlDatabase::database(m_connectionName);
+    QSqlQuery q{db};
+
+    // the staging table lives as long as the session, so it is only created once per connection
+    if (Q_UNLIKELY(!q.exec(uR"-(CREATE TEMP TABLE IF NOT EXISTS items_staging (guid TEXT, title TEXT, description TEXT, author TEXT, link TEXT, "pubDate" TIMESTAMP))-"_s))) {
+        m_lastError = q.lastError();
+        return false;
+    }
+
+    if (Q_UNLIKELY(!q.exec(u"TRUNCATE items_staging"_s))) {
+        m_lastError = q.lastError();
+        return false;
+    }
+    q.finish();
+
+    const QVariant handle = db.driver()->handle();
+    if (Q_UNLIKELY(!handle.isValid() || qstrcmp(handle.typeName(), "PGconn*") != 0)) {
+        m_lastError = QSqlError{u"Failed to get PostgreSQL connection handle"_s, QString(), QSqlError::ConnectionError};
+        return false;
+    }
+    PGconn *conn = *static_cast<PGconn *const *>(handle.constData());
+
+    PGresult *res = PQexec(conn, R"-(COPY items_staging (guid, title, description, author, link, "pubDate") FROM STDIN (FORMAT binary))-");
+    const bool copyStarted = PQresultStatus(res) == PGRES_COPY_IN;
+    PQclear(res);
+    if (Q_UNLIKELY(!copyStarted)) {
+        m_lastError = libpqError(conn, u"Failed to start COPY of items"_s);
+        finishCommand(conn);
+        return false;
+    }
+
+    CopyWriter writer{conn};
+    for (const auto &item : items) {
+        writer.startRow(6);
+        writer.addText(item.guid());
+        writer.addText(clamped(item.title(), maxTitleLength));
+        writer.addText(Utils::cleanDescription(item.description(), m_maxDescriptionLength));
+        writer.addText(clamped(item.author(), maxAuthorLength));
+        writer.addText(linkValue(item));
+        writer.addTimestamp(item.pubDate());
+        if (Q_UNLIKELY(!writer.endRow())) {
+            m_lastError = libpqError(conn, u"Failed to send items with COPY"_s);
+            abortCopy(conn);
+            return false;
+        }
+    }
+
+    if (Q_UNLIKELY(!writer.finish())) {
+        m_lastError = libpqError(conn, u"Failed to finish COPY of items"_s);
+        abortCopy(conn);
+        return false;
+    }
+
+    if (Q_UNLIKELY(!finishCommand(conn))) {
+        m_lastError = libpqError(conn, u"Failed to finish COPY of items"_s);
+        return false;
+    }
+
+    // merge all staged items with a single statement
+    if (Q_UNLIKELY(!q.prepare(uR"-(INSERT INTO items ("feedId", guid, title, description, author, link, "pubDate")
+                                   SELECT :feedId, guid, title, description, author, link, "pubDate" FROM items_staging)-"_s
+                              + upsertConflictClause))) {
+        m_lastError = q.lastError();
+        return false;
+    }
+
+    q.bindValue(u":feedId"_s, feedId);
+    q.setForwardOnly(true);
+
+    if (Q_UNLIKELY(!q.exec())) {
+        m_lastError = q.lastError();
+        return false;
+    }
+
+    collectUpserted(q, itemsByGuid, newItems, updatedItems);
+
+    return true;
+}
+#endif
+
+bool ItemStore::removeUnchanged(QList<FeedItem> &items)
+{
+    QSqlQuery q{QSqlDatabase::database(m_connectionName)};
+    q.setForwardOnly(true);
+
+    QSet<QString> unchanged;
+
+    for (qsizetype offset = 0; offset < items.size(); offset += maxRowsPerStatement) {
+        const auto batch = items.sliced(offset, std::min(maxRowsPerStatement, items.size() - offset));
+
+        QStringList values;
+        values.reserve(batch.size());
+        for (qsizetype i = 0; i < batch.size(); ++i) {
+            values << u"(?, CAST(? AS timestamp))"_s;
+        }
+
+        // the same condition as in the ON CONFLICT clause of upsert(), negated and NULL safe
+        const QString qs = uR"-(SELECT v.guid FROM (VALUES )-"_s
+                + values.join(", "_L1)
+                + uR"-() AS v(guid, "pubDate") JOIN items i ON i.guid = v.guid
+                      WHERE (v."pubDate" > i."pubDate") IS NOT TRUE)-"_s;
+
+        if (Q_UNLIKELY(!q.prepare(qs))) {
+            m_lastError = q.lastError();
+            return false;
+        }
+
+        for (const auto &item : batch) {
+            q.addBindValue(item.guid());
+            q.addBindValue(item.pubDate());
+        }
+
+        if (Q_UNLIKELY(!q.exec())) {
+            m_lastError = q.lastError();
+            return false;
+        }
+
+        while (q.next()) {
+            unchanged.insert(q.value(0).toString());
+        }
+    }
+
+    if (!unchanged.empty()) {
+        items.removeIf([&unchanged](const FeedItem &item){
+            return unchanged.contains(item.guid());
+        });
+    }
+
+    return true;
+}
+
+bool ItemStore::addImageStats(int feedId, int imagesFromFeed, int pagesScraped)
+{
+    if (imagesFromFeed == 0 && pagesScraped == 0) {
+        return true;
+    }
+
+    QSqlQuery q{QSqlDatabase::database(m_connectionName)};
+
+    if (Q_UNLIKELY(!q.prepare(uR"-(UPDATE feeds SET data = COALESCE(data, '{}'::jsonb) || jsonb_build_object(
+                                   'imagesFromFeed', COALESCE((data->>'imagesFromFeed')::integer, 0) + :imagesFromFeed,
+                                   'pagesScraped', COALESCE((data->>'pagesScraped')::integer, 0) + :pagesScraped)
+                              WHERE id = :id)-"_s))) {
+        m_lastError = q.lastError();
+        return false;
+    }
+
+    q.bindValue(u":imagesFromFeed"_s, imagesFromFeed);
+    q.bindValue(u":pagesScraped"_s, pagesScraped);
+    q.bindValue(u":id"_s, feedId);
+
+    if (Q_UNLIKELY(!q.exec())) {
+        m_lastError = q.lastError();
+        return false;
+    }
+
+    return true;
+}
+
+bool ItemStore::setImages(const QVariantMap &itemImages)
+{
+    QSqlQuery q{QSqlDatabase::database(m_connectionName)};
+
+    const QStringList guids = itemImages.keys();
+    for (qsizetype offset = 0; offset < guids.size(); offset += maxRowsPerStatement) {
+        const auto batch = guids.sliced(offset, std::min(maxRowsPerStatement, guids.size() - offset));
+
+        QStringList values;
+        values.reserve(batch.size());
+        for (qsizetype i = 0; i < batch.size(); ++i) {
+            values << u"(?, ?::jsonb)"_s;
+        }
+
+        // merge the image into the existing data on the server instead of reading it first
+        const QString qs = uR"-(UPDATE items SET data = COALESCE(items.data, '{}'::jsonb) || jsonb_build_object('image', v.image) FROM (VALUES )-"_s
+                + values.join(", "_L1)
+                + uR"-() AS v(guid, image) WHERE items.guid = v.guid)-"_s;
+
+        if (Q_UNLIKELY(!q.prepare(qs))) {
+            m_lastError = q.lastError();
+            return false;
+        }
+
+        for (const QString &guid : batch) {
+            q.addBindValue(guid);
+            q.addBindValue(QString::fromUtf8(QJsonDocument(QJsonObject::fromVariantMap(itemImages.value(guid).toMap())).toJson(QJsonDocument::Compact)));
+        }
+
+        if (Q_UNLIKELY(!q.exec())) {
+            m_lastError = q.lastError();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+QSqlError ItemStore::lastError() const
+{
+    return m_lastError;
+}
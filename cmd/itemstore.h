@@ -0,0 +1,110 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef HBNST_ITEMSTORE_H
+#define HBNST_ITEMSTORE_H
+
+#include "feed.h"
+
+#include <QHash>
+#include <QList>
+#include <QSqlError>
+#include <QString>
+#include <QVariantMap>
+
+class Configuration;
+
+/*!
+ * \brief Writes feed items to the database using batched statements.
+ *
+ * %ItemStore does not open transactions on its own. Callers that want
+ * to write a feed atomically have to wrap the calls into a transaction.
+ */
+class ItemStore
+{
+public:
+    /*!
+     * \brief Constructs a new %ItemStore that uses the database connection identified by \a connectionName.
+     */
+    explicit ItemStore(const QString &connectionName);
+
+    /*!
+     * \brief Reads the maximum item description length from the \c feeds section of the \a config.
+     */
+    void loadConfig(const Configuration *config);
+
+    /*!
+     * \brief Sets the maximum length of item descriptions, \c 0 disables truncation.
+     */
+    void setMaxDescriptionLength(qsizetype maxLength);
+
+    /*!
+     * \brief Sets whether upsert() looks up the stored items first to skip unchanged ones.
+     *
+     * Items whose publication date is not newer than the stored one would be discarded by
+     * the database anyway, so they are neither cleaned nor sent. This is enabled by default
+     * and can be disabled for feeds that have just been created.
+     */
+    void setCheckUnchanged(bool check);
+
+    /*!
+     * \brief Sets the minimum number of items that upsert() writes with \c COPY instead of \c INSERT statements.
+     *
+     * Has no effect if statalih has been built without libpq. The default is \c 1000.
+     */
+    void setMinRowsForCopy(qsizetype minRows);
+
+    /*!
+     * \brief Inserts new and updates changed \a items of the feed identified by \a feedId.
+     *
+     * Existing items are identified by their guid and will only be updated if their
+     * publication date is newer than the one stored in the database. Inserted items
+     * will be added to \a newItems, updated items to \a updatedItems. Returns \c false
+     * on error, use lastError() to get the error.
+     *
+     * Titles, authors and links that exceed the size of their database columns will be
+     * truncated, items with a too long guid will be skipped.
+     *
+     * If statalih has been built with libpq, large numbers of items will be copied
+     * into a temporary staging table with binary \c COPY and merged from there.
+     */
+    bool upsert(int feedId, const QList<FeedItem> &items, QList<FeedItem> *newItems = nullptr, QList<FeedItem> *updatedItems = nullptr);
+
+    /*!
+     * \brief Adds the numbers of item images taken from the feed and of scraped item pages
+     * to the statistics in the data of the feed identified by \a feedId.
+     */
+    bool addImageStats(int feedId, int imagesFromFeed, int pagesScraped);
+
+    /*!
+     * \brief Sets the image data of the items identified by the guid keys of \a itemImages.
+     *
+     * The values have to be QVariantMap objects that will be merged as \c image key into
+     * the JSON data of the items. Returns \c false on error, use lastError() to get the error.
+     */
+    bool setImages(const QVariantMap &itemImages);
+
+    /*!
+     * \brief Returns the last database error.
+     */
+    [[nodiscard]] QSqlError lastError() const;
+
+private:
+    bool removeUnchanged(QList<FeedItem> &items);
+
+#ifdef WITH_LIBPQ
+    bool copyUpsert(int feedId, const QList<FeedItem> &items, const QHash<QString,FeedItem> &itemsByGuid, QList<FeedItem> *newItems, QList<FeedItem> *updatedItems);
+#endif
+
+    QString m_connectionName;
+    QSqlError m_lastError;
+    qsizetype m_maxDescriptionLength{0};
+    qsizetype m_minRowsForCopy{1000};
+    bool m_checkUnchanged{true};
+
+    static constexpr qsizetype maxRowsPerStatement{500};
+};
+
+#endif // HBNST_ITEMSTORE_H
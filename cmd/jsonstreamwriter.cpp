@@ -0,0 +1,238 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "jsonstreamwriter.h"
+
+#include <QDate>
+#include <QDateTime>
+#include <QLocale>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QTime>
+#include <QVariant>
+
+#include <cmath>
+#include <cstdio>
+#include <utility>
+
+using namespace Qt::StringLiterals;
+
+namespace {
+constexpr qsizetype bufferSize{64 * 1024};
+}
+
+JsonStreamWriter::JsonStreamWriter(Format format)
+    : m_format{format}
+{
+    // uses the stdio buffer of stdout, so the output keeps its order with printf
+    m_out.open(stdout, QIODeviceBase::WriteOnly);
+}
+
+JsonStreamWriter::~JsonStreamWriter()
+{
+    flush();
+}
+
+std::optional<JsonStreamWriter::Format> JsonStreamWriter::formatFromName(QStringView name)
+{
+    if (name == "json"_L1) {
+        return Format::Compact;
+    }
+    if (name == "json-pretty"_L1) {
+        return Format::Indented;
+    }
+    if (name == "ndjson"_L1) {
+        return Format::Lines;
+    }
+    return std::nullopt;
+}
+
+qint64 JsonStreamWriter::writeQuery(QSqlQuery &query)
+{
+    const bool indented = m_format == Format::Indented;
+
+    // the keys are the same for every row, so they are only escaped once
+    const QSqlRecord record = query.record();
+    const int columns = record.count();
+    QList<QByteArray> keys;
+    keys.reserve(columns);
+    for (int i = 0; i < columns; ++i) {
+        if (indented) {
+            m_buffer += "        ";
+        }
+        writeString(record.fieldName(i));
+        m_buffer += indented ? ": " : ":";
+        keys << std::exchange(m_buffer, {});
+    }
+    m_buffer.reserve(bufferSize + 1024);
+
+    if (m_format != Format::Lines) {
+        m_buffer += '[';
+    }
+
+    qint64 rows = 0;
+    for (bool valid = query.isValid() || query.next(); valid; valid = query.next()) {
+        if (m_format == Format::Lines) {
+            if (rows > 0) {
+                m_buffer += '\n';
+            }
+        } else {
+            if (rows > 0) {
+                m_buffer += ',';
+            }
+            if (indented) {
+                m_buffer += "\n    ";
+            }
+        }
+
+        m_buffer += '{';
+        for (int i = 0; i < columns; ++i) {
+            if (i > 0) {
+                m_buffer += ',';
+            }
+            if (indented) {
+                m_buffer += '\n';
+            }
+            m_buffer += keys.at(i);
+            writeValue(query.value(i));
+        }
+        if (indented) {
+            m_buffer += "\n    ";
+        }
+        m_buffer += '}';
+
+        ++rows;
+
+        if (m_buffer.size() >= bufferSize) {
+            flush();
+        }
+    }
+
+    if (m_format != Format::Lines) {
+        if (indented && rows > 0) {
+            m_buffer += '\n';
+        }
+        m_buffer += ']';
+    }
+    m_buffer += '\n';
+
+    flush();
+
+    return rows;
+}
+
+void JsonStreamWriter::writeValue(const QVariant &value)
+{
+    if (value.isNull()) {
+        m_buffer += "null";
+        return;
+    }
+
+    switch (value.typeId()) {
+    case QMetaType::Bool:
+        m_buffer += value.toBool() ? "true" : "false";
+        break;
+    case QMetaType::Int:
+    case QMetaType::Short:
+    case QMetaType::Long:
+    case QMetaType::LongLong:
+        m_buffer += QByteArray::number(value.toLongLong());
+        break;
+    case QMetaType::UInt:
+    case QMetaType::UShort:
+    case QMetaType::ULong:
+    case QMetaType::ULongLong:
+        m_buffer += QByteArray::number(value.toULongLong());
+        break;
+    case QMetaType::Float:
+    case QMetaType::Double:
+    {
+        const double d = value.toDouble();
+        if (std::isfinite(d)) {
+            m_buffer += QByteArray::number(d, 'g', QLocale::FloatingPointShortest);
+        } else {
+            m_buffer += "null";
+        }
+        break;
+    }
+    case QMetaType::QDateTime:
+        writeString(value.toDateTime().toString(Qt::ISODateWithMs));
+        break;
+    case QMetaType::QDate:
+        writeString(value.toDate().toString(Qt::ISODate));
+        break;
+    case QMetaType::QTime:
+        writeString(value.toTime().toString(Qt::ISODateWithMs));
+        break;
+    case QMetaType::QByteArray:
+        m_buffer += '"';
+        m_buffer += value.toByteArray().toBase64();
+        m_buffer += '"';
+        break;
+    default:
+        writeString(value.toString());
+        break;
+    }
+}
+
+void JsonStreamWriter::writeString(QStringView str)
+{
+    static constexpr char hexDigits[] = "0123456789abcdef";
+
+    m_buffer += '"';
+
+    qsizetype runStart = 0;
+    for (qsizetype i = 0; i < str.size(); ++i) {
+        const char16_t c = str.at(i).unicode();
+        if (c >= 0x20 && c != u'"' && c != u'\\') {
+            continue;
+        }
+
+        m_buffer += str.sliced(runStart, i - runStart).toUtf8();
+        runStart = i + 1;
+
+        switch (c) {
+        case u'"':
+            m_buffer += "\\\"";
+            break;
+        case u'\\':
+            m_buffer += "\\\\";
+            break;
+        case u'\n':
+            m_buffer += "\\n";
+            break;
+        case u'\r':
+            m_buffer += "\\r";
+            break;
+        case u'\t':
+            m_buffer += "\\t";
+            break;
+        case u'\b':
+            m_buffer += "\\b";
+            break;
+        case u'\f':
+            m_buffer += "\\f";
+            break;
+        default:
+            m_buffer += "\\u00";
+            m_buffer += hexDigits[c >> 4];
+            m_buffer += hexDigits[c & 0xf];
+            break;
+        }
+    }
+    m_buffer += str.sliced(runStart).toUtf8();
+
+    m_buffer += '"';
+}
+
+void JsonStreamWriter::flush()
+{
+    if (!m_buffer.isEmpty()) {
+        m_out.write(m_buffer);
+        m_out.flush();
+        // keeps the capacity of the buffer
+        m_buffer.truncate(0);
+    }
+}
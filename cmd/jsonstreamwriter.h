@@ -0,0 +1,65 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef HBNST_JSONSTREAMWRITER_H
+#define HBNST_JSONSTREAMWRITER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QList>
+#include <QStringView>
+
+#include <optional>
+
+class QSqlQuery;
+class QVariant;
+
+/*!
+ * \brief Writes the rows of a query result as JSON objects to stdout.
+ *
+ * Every row is serialized as soon as it has been read from the query and the
+ * output is written in chunks, so memory usage does not depend on the size
+ * of the result. The keys of the objects are the column names in the order
+ * of the query.
+ */
+class JsonStreamWriter
+{
+public:
+    enum class Format : int {
+        Compact = 0,    /**< Single line JSON array, like <tt>--format json</tt> */
+        Indented,       /**< Indented JSON array, like <tt>--format json-pretty</tt> */
+        Lines           /**< One JSON object per line, like <tt>--format ndjson</tt> */
+    };
+
+    explicit JsonStreamWriter(Format format);
+    ~JsonStreamWriter();
+
+    /*!
+     * \brief Returns the format for the \a name used by the \c --format option.
+     *
+     * Returns \c std::nullopt if \a name is not a JSON format.
+     */
+    [[nodiscard]] static std::optional<Format> formatFromName(QStringView name);
+
+    /*!
+     * \brief Writes the current and all remaining rows of the active \a query and returns the number of written rows.
+     *
+     * If the \a query is not positioned on a valid row, writing starts with the next row.
+     */
+    qint64 writeQuery(QSqlQuery &query);
+
+private:
+    void writeValue(const QVariant &value);
+    void writeString(QStringView str);
+    void flush();
+
+    QFile m_out;
+    QByteArray m_buffer;
+    Format m_format;
+
+    Q_DISABLE_COPY(JsonStreamWriter)
+};
+
+#endif // HBNST_JSONSTREAMWRITER_H
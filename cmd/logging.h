@@ -0,0 +1,14 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef HBNST_CMD_LOGGING_H
+#define HBNST_CMD_LOGGING_H
+
+#include <QLoggingCategory>
+
+Q_DECLARE_LOGGING_CATEGORY(ST_UPDATER)
+Q_DECLARE_LOGGING_CATEGORY(ST_ITEMS)
+
+#endif // HBNST_CMD_LOGGING_H
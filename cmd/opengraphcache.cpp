@@ -0,0 +1,118 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "opengraphcache.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
+#include <algorithm>
+
+using namespace Qt::StringLiterals;
+
+OpenGraphCache::OpenGraphCache(const QString &connectionName)
+    : m_connectionName{connectionName}
+{
+
+}
+
+QHash<QString,OpenGraphCache::Entry> OpenGraphCache::lookup(const QStringList &links)
+{
+    QHash<QString,Entry> entries;
+    if (links.empty()) {
+        return entries;
+    }
+
+    QSqlQuery q{QSqlDatabase::database(m_connectionName)};
+    q.setForwardOnly(true);
+
+    for (qsizetype offset = 0; offset < links.size(); offset += maxRowsPerStatement) {
+        const auto batch = links.sliced(offset, std::min(maxRowsPerStatement, links.size() - offset));
+
+        QStringList placeholders;
+        placeholders.reserve(batch.size());
+        for (qsizetype i = 0; i < batch.size(); ++i) {
+            placeholders << u"?"_s;
+        }
+
+        if (Q_UNLIKELY(!q.prepare(uR"-(SELECT link, image, "fetchedAt", etag, "lastModified" FROM opengraph WHERE link IN ()-"_s + placeholders.join(", "_L1) + u")"_s))) {
+            m_lastError = q.lastError();
+            return entries;
+        }
+
+        for (const auto &link : batch) {
+            q.addBindValue(link);
+        }
+
+        if (Q_UNLIKELY(!q.exec())) {
+            m_lastError = q.lastError();
+            return entries;
+        }
+
+        while (q.next()) {
+            entries.insert(q.value(0).toString(), {
+                               QJsonDocument::fromJson(q.value(1).toByteArray()).object().toVariantMap(),
+                               q.value(2).toDateTime(),
+                               q.value(3).toString(),
+                               q.value(4).toString()
+                           });
+        }
+    }
+
+    return entries;
+}
+
+bool OpenGraphCache::store(const QHash<QString,Entry> &entries)
+{
+    if (entries.empty()) {
+        return true;
+    }
+
+    const QStringList links = entries.keys();
+
+    QSqlQuery q{QSqlDatabase::database(m_connectionName)};
+
+    for (qsizetype offset = 0; offset < links.size(); offset += maxRowsPerStatement) {
+        const auto batch = links.sliced(offset, std::min(maxRowsPerStatement, links.size() - offset));
+
+        QStringList values;
+        values.reserve(batch.size());
+        for (qsizetype i = 0; i < batch.size(); ++i) {
+            values << u"(?, ?, ?, ?, ?)"_s;
+        }
+
+        const QString qs = uR"-(INSERT INTO opengraph (link, image, "fetchedAt", etag, "lastModified") VALUES )-"_s
+                + values.join(", "_L1)
+                + uR"-( ON CONFLICT (link) DO UPDATE SET image = excluded.image, "fetchedAt" = excluded."fetchedAt", etag = excluded.etag, "lastModified" = excluded."lastModified")-"_s;
+
+        if (Q_UNLIKELY(!q.prepare(qs))) {
+            m_lastError = q.lastError();
+            return false;
+        }
+
+        for (const auto &link : batch) {
+            const Entry &entry = entries[link];
+            q.addBindValue(link);
+            q.addBindValue(QString::fromUtf8(QJsonDocument(QJsonObject::fromVariantMap(entry.image)).toJson(QJsonDocument::Compact)));
+            q.addBindValue(entry.fetchedAt);
+            q.addBindValue(entry.etag.isEmpty() ? QVariant() : entry.etag);
+            q.addBindValue(entry.lastModified.isEmpty() ? QVariant() : entry.lastModified);
+        }
+
+        if (Q_UNLIKELY(!q.exec())) {
+            m_lastError = q.lastError();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+QSqlError OpenGraphCache::lastError() const
+{
+    return m_lastError;
+}
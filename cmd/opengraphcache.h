@@ -0,0 +1,62 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef HBNST_OPENGRAPHCACHE_H
+#define HBNST_OPENGRAPHCACHE_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QSqlError>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+
+/*!
+ * \brief Stores OpenGraph image data of web pages in the database.
+ *
+ * Entries are keyed by the normalized page link, see Utils::normalizeUrl(). Besides
+ * the extracted image data, the cache validators of the page response are stored
+ * to send conditional requests when an entry has to be refreshed.
+ */
+class OpenGraphCache
+{
+public:
+    struct Entry {
+        QVariantMap image;
+        QDateTime fetchedAt;
+        QString etag;
+        QString lastModified;
+    };
+
+    /*!
+     * \brief Constructs a new %OpenGraphCache that uses the database connection identified by \a connectionName.
+     */
+    explicit OpenGraphCache(const QString &connectionName);
+
+    /*!
+     * \brief Returns the cached entries for the normalized \a links.
+     *
+     * Links that are not cached will not be part of the returned hash.
+     */
+    [[nodiscard]] QHash<QString,Entry> lookup(const QStringList &links);
+
+    /*!
+     * \brief Inserts or replaces the \a entries, keyed by normalized link.
+     */
+    bool store(const QHash<QString,Entry> &entries);
+
+    /*!
+     * \brief Returns the last database error.
+     */
+    [[nodiscard]] QSqlError lastError() const;
+
+private:
+    QString m_connectionName;
+    QSqlError m_lastError;
+
+    static constexpr qsizetype maxRowsPerStatement{500};
+};
+
+#endif // HBNST_OPENGRAPHCACHE_H
@@ -0,0 +1,209 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "opengraphscanner.h"
+
+#include <QUrl>
+
+using namespace Qt::StringLiterals;
+
+namespace {
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+// returns true if tag starts with the element name, case-insensitive
+bool isElement(QByteArrayView tag, QByteArrayView name)
+{
+    if (tag.size() < name.size() || tag.first(name.size()).compare(name, Qt::CaseInsensitive) != 0) {
+        return false;
+    }
+    return tag.size() == name.size() || isSpace(tag.at(name.size())) || tag.at(name.size()) == '/';
+}
+
+QString decodeValue(QByteArrayView value)
+{
+    QString str = QString::fromUtf8(value);
+    if (str.contains('&'_L1)) {
+        str.replace("&quot;"_L1, "\""_L1).replace("&#39;"_L1, "'"_L1).replace("&lt;"_L1, "<"_L1).replace("&gt;"_L1, ">"_L1).replace("&amp;"_L1, "&"_L1);
+    }
+    return str;
+}
+
+} // namespace
+
+OpenGraphScanner::OpenGraphScanner(qsizetype maxBytes)
+    : m_maxBytes{maxBytes}
+{
+
+}
+
+bool OpenGraphScanner::addData(QByteArrayView data)
+{
+    if (m_done) {
+        return true;
+    }
+
+    m_bytesRead += data.size();
+    m_buffer.append(data);
+
+    qsizetype pos = 0;
+    while (!m_done) {
+        const qsizetype start = m_buffer.indexOf('<', pos);
+        if (start < 0) {
+            pos = m_buffer.size();
+            break;
+        }
+
+        const QByteArrayView rest = QByteArrayView(m_buffer).sliced(start);
+        if (rest.startsWith("<!--")) {
+            const qsizetype end = m_buffer.indexOf("-->", start + 4);
+            if (end < 0) {
+                pos = start;
+                break;
+            }
+            pos = end + 3;
+            continue;
+        }
+
+        const qsizetype end = m_buffer.indexOf('>', start + 1);
+        if (end < 0) {
+            pos = start;
+            break;
+        }
+
+        scanTag(QByteArrayView(m_buffer).sliced(start + 1, end - start - 1));
+        pos = end + 1;
+    }
+
+    // keep only an incomplete tag for the next chunk
+    m_buffer.remove(0, pos);
+
+    if (m_maxBytes > 0 && m_bytesRead >= m_maxBytes) {
+        m_done = true;
+    }
+
+    if (m_done) {
+        m_buffer.clear();
+        m_buffer.squeeze();
+    }
+
+    return m_done;
+}
+
+bool OpenGraphScanner::isDone() const noexcept
+{
+    return m_done;
+}
+
+qsizetype OpenGraphScanner::maxBytes() const noexcept
+{
+    return m_maxBytes;
+}
+
+QVariantMap OpenGraphScanner::image() const
+{
+    return m_image;
+}
+
+void OpenGraphScanner::scanTag(QByteArrayView tag)
+{
+    if (isElement(tag, "/head") || isElement(tag, "body")) {
+        m_done = true;
+        return;
+    }
+
+    if (!isElement(tag, "meta")) {
+        return;
+    }
+
+    QByteArrayView property;
+    QByteArrayView content;
+
+    qsizetype i = 4;
+    const qsizetype size = tag.size();
+    while (i < size) {
+        while (i < size && (isSpace(tag.at(i)) || tag.at(i) == '/')) {
+            ++i;
+        }
+
+        const qsizetype nameStart = i;
+        while (i < size && !isSpace(tag.at(i)) && tag.at(i) != '=' && tag.at(i) != '/') {
+            ++i;
+        }
+        const QByteArrayView name = tag.sliced(nameStart, i - nameStart);
+
+        while (i < size && isSpace(tag.at(i))) {
+            ++i;
+        }
+
+        QByteArrayView value;
+        if (i < size && tag.at(i) == '=') {
+            ++i;
+            while (i < size && isSpace(tag.at(i))) {
+                ++i;
+            }
+            if (i < size && (tag.at(i) == '"' || tag.at(i) == '\'')) {
+                const char quote = tag.at(i++);
+                const qsizetype valueStart = i;
+                while (i < size && tag.at(i) != quote) {
+                    ++i;
+                }
+                value = tag.sliced(valueStart, i - valueStart);
+                ++i;
+            } else {
+                const qsizetype valueStart = i;
+                while (i < size && !isSpace(tag.at(i))) {
+                    ++i;
+                }
+                value = tag.sliced(valueStart, i - valueStart);
+            }
+        }
+
+        // some sites use name instead of property for OpenGraph tags
+        if (name.compare("property", Qt::CaseInsensitive) == 0 || (property.isEmpty() && name.compare("name", Qt::CaseInsensitive) == 0)) {
+            property = value;
+        } else if (name.compare("content", Qt::CaseInsensitive) == 0) {
+            content = value;
+        }
+    }
+
+    if (property.startsWith("og:image") && !content.isEmpty()) {
+        addProperty(property, content);
+    }
+}
+
+void OpenGraphScanner::addProperty(QByteArrayView property, QByteArrayView content)
+{
+    if (property == "og:image" || property == "og:image:url") {
+        const QUrl url{decodeValue(content)};
+        if (url.isValid()) {
+            m_image.insert(u"url"_s, url);
+        }
+    } else if (property == "og:image:secure_url") {
+        const QUrl url{decodeValue(content)};
+        if (url.isValid()) {
+            m_image.insert(u"secure_url"_s, url);
+        }
+    } else if (property == "og:image:width") {
+        bool ok{false};
+        const int width = content.toInt(&ok);
+        if (ok) {
+            m_image.insert(u"width"_s, width);
+        }
+    } else if (property == "og:image:height") {
+        bool ok{false};
+        const int height = content.toInt(&ok);
+        if (ok) {
+            m_image.insert(u"height"_s, height);
+        }
+    } else if (property == "og:image:alt") {
+        m_image.insert(u"alt"_s, decodeValue(content));
+    } else if (property == "og:image:type") {
+        m_image.insert(u"type"_s, decodeValue(content));
+    }
+}
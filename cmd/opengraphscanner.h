@@ -0,0 +1,54 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef HBNST_OPENGRAPHSCANNER_H
+#define HBNST_OPENGRAPHSCANNER_H
+
+#include <QByteArray>
+#include <QVariantMap>
+
+/*!
+ * \brief Incremental scanner for OpenGraph image meta tags in HTML data.
+ *
+ * The scanner works directly on the raw bytes of the page and only converts the
+ * values of matching meta tags. It is done as soon as the end of the head element
+ * or the start of the body element has been found or if more than maxBytes() have
+ * been added, so the rest of the page does not have to be downloaded.
+ */
+class OpenGraphScanner
+{
+public:
+    explicit OpenGraphScanner(qsizetype maxBytes = 256 * 1024);
+
+    /*!
+     * \brief Scans the next chunk of \a data.
+     *
+     * Returns \c true if the scanner is done and no more data is needed.
+     */
+    bool addData(QByteArrayView data);
+
+    [[nodiscard]] bool isDone() const noexcept;
+
+    [[nodiscard]] qsizetype maxBytes() const noexcept;
+
+    /*!
+     * \brief Returns the found image data.
+     *
+     * Possible keys are \c url, \c secure_url, \c width, \c height, \c alt and \c type.
+     */
+    [[nodiscard]] QVariantMap image() const;
+
+private:
+    void scanTag(QByteArrayView tag);
+    void addProperty(QByteArrayView property, QByteArrayView content);
+
+    QByteArray m_buffer;
+    QVariantMap m_image;
+    qsizetype m_maxBytes{0};
+    qsizetype m_bytesRead{0};
+    bool m_done{false};
+};
+
+#endif // HBNST_OPENGRAPHSCANNER_H
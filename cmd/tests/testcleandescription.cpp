@@ -0,0 +1,152 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "utils.h"
+
+#include <QObject>
+#include <QRegularExpression>
+#include <QTest>
+
+using namespace Qt::StringLiterals;
+
+class TestCleanDescription final : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+
+    void cleanDescription_data();
+    void cleanDescription();
+
+    void benchmark_data();
+    void benchmark();
+
+private:
+    QStringList m_corpus;
+};
+
+namespace {
+
+// the implementation used before the single pass parser, kept as reference for the benchmark
+QString regexCleanDescription(const QString &desc)
+{
+    static QRegularExpression tagRegEx{u"<[^>]*>"_s};
+    QString cleaned = desc.simplified();
+    cleaned.remove(tagRegEx);
+    return cleaned;
+}
+
+}
+
+void TestCleanDescription::initTestCase()
+{
+    // descriptions as found in real feeds: paragraphs, links, images, entities and the odd script
+    const QStringList samples{
+        uR"(<p>The city council decided on Tuesday to extend the <a href="https://example.com/park?utm_source=rss" title="Park &gt; Garden">park</a> by another two hectares.</p>
+<p><img src="https://example.com/images/park.jpg" alt="The park" width="640" height="480"></p>
+<p>&bdquo;This is a great day for our city&ldquo;, said the mayor &ndash; the work will start next spring.</p>)"_s,
+        uR"(<div class="feed-description"><h2>Release notes</h2><ul><li>Fixed a crash when opening &lt;empty&gt; files</li><li>Improved the startup time by 30&nbsp;%</li><li>Updated translations</li></ul><script type="text/javascript">var tracking = '<img src="pixel.gif">';</script></div>)"_s,
+        uR"(<![CDATA[Short teaser text without any markup but a long enough sentence to be realistic for a feed item.]]>)"_s,
+        uR"(Plain text description of an article, some feeds do not use HTML at all and just put the first sentences of the article into the description element.)"_s,
+    };
+
+    constexpr qsizetype corpusSize = 10'000;
+    m_corpus.reserve(corpusSize);
+    for (qsizetype i = 0; i < corpusSize; ++i) {
+        m_corpus << samples.at(i % samples.size());
+    }
+}
+
+void TestCleanDescription::cleanDescription_data()
+{
+    QTest::addColumn<QString>("desc");
+    QTest::addColumn<qsizetype>("maxLength");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("empty") << QString{} << qsizetype{0} << QString{};
+    QTest::newRow("plain") << u"Hello World"_s << qsizetype{0} << u"Hello World"_s;
+    QTest::newRow("whitespace") << u"  Hello \n\t World  "_s << qsizetype{0} << u"Hello World"_s;
+
+    // tags
+    QTest::newRow("inline-tags") << u"<b>Hello</b> <i>World</i>"_s << qsizetype{0} << u"Hello World"_s;
+    QTest::newRow("inline-in-word") << u"Hel<b>lo</b>"_s << qsizetype{0} << u"Hello"_s;
+    QTest::newRow("block-tags") << u"<p>First</p><p>Second</p>"_s << qsizetype{0} << u"First Second"_s;
+    QTest::newRow("br") << u"Line<br/>Break"_s << qsizetype{0} << u"Line Break"_s;
+    QTest::newRow("img") << u"Text<img src=\"a.png\">More"_s << qsizetype{0} << u"Text More"_s;
+    QTest::newRow("quoted-gt") << u"<a href=\"x>y\" title='a>b'>Link</a>"_s << qsizetype{0} << u"Link"_s;
+    QTest::newRow("uppercase") << u"<P>First</P><DIV>Second</DIV>"_s << qsizetype{0} << u"First Second"_s;
+    QTest::newRow("lone-lt") << u"1 < 2"_s << qsizetype{0} << u"1 < 2"_s;
+
+    // skipped content
+    QTest::newRow("script") << u"Before<script>var a = '<p>';</script>After"_s << qsizetype{0} << u"Before After"_s;
+    QTest::newRow("style") << u"<style>p { color: red; }</style>Text"_s << qsizetype{0} << u"Text"_s;
+    QTest::newRow("comment") << u"Before<!-- <p>hidden</p> -->After"_s << qsizetype{0} << u"Before After"_s;
+    QTest::newRow("doctype") << u"<!DOCTYPE html><p>Text</p>"_s << qsizetype{0} << u"Text"_s;
+    QTest::newRow("cdata") << u"<![CDATA[<b>&amp;</b>]]>"_s << qsizetype{0} << u"<b>&amp;</b>"_s;
+
+    // character references
+    QTest::newRow("named-entities") << u"Tom &amp; Jerry &ndash; &quot;Cartoon&quot;"_s << qsizetype{0} << u"Tom & Jerry – \"Cartoon\""_s;
+    QTest::newRow("numeric-entities") << u"&#8220;Quote&#x201D;"_s << qsizetype{0} << u"“Quote”"_s;
+    QTest::newRow("astral-entity") << u"&#x1F600;"_s << qsizetype{0} << u"\U0001F600"_s;
+    QTest::newRow("nbsp") << u"a&nbsp;&nbsp;b"_s << qsizetype{0} << u"a b"_s;
+    QTest::newRow("unknown-entity") << u"&foo; &"_s << qsizetype{0} << u"&foo; &"_s;
+    QTest::newRow("unterminated-entity") << u"AT&T rocks; really"_s << qsizetype{0} << u"AT&T rocks; really"_s;
+    QTest::newRow("surrogate-entity") << u"&#xD800;"_s << qsizetype{0} << u"&#xD800;"_s;
+
+    // truncation
+    QTest::newRow("short") << u"Short text"_s << qsizetype{100} << u"Short text"_s;
+    QTest::newRow("truncate-word") << u"The quick brown fox jumps"_s << qsizetype{15} << u"The quick…"_s;
+    QTest::newRow("truncate-tags") << u"<p>The quick</p><p>brown fox jumps</p>"_s << qsizetype{15} << u"The quick…"_s;
+}
+
+void TestCleanDescription::cleanDescription()
+{
+    QFETCH(QString, desc);
+    QFETCH(qsizetype, maxLength);
+    QFETCH(QString, expected);
+
+    const QString result = Utils::cleanDescription(desc, maxLength);
+    QCOMPARE(result, expected);
+    if (maxLength > 0) {
+        QVERIFY(result.size() <= maxLength);
+    }
+}
+
+void TestCleanDescription::benchmark_data()
+{
+    QTest::addColumn<bool>("useRegex");
+
+    QTest::newRow("cleanDescription") << false;
+    QTest::newRow("regex") << true;
+}
+
+void TestCleanDescription::benchmark()
+{
+    QFETCH(bool, useRegex);
+
+    qsizetype length = 0;
+
+    if (useRegex) {
+        QBENCHMARK {
+            length = 0;
+            for (const QString &desc : std::as_const(m_corpus)) {
+                length += regexCleanDescription(desc).size();
+            }
+        }
+    } else {
+        QBENCHMARK {
+            length = 0;
+            for (const QString &desc : std::as_const(m_corpus)) {
+                length += Utils::cleanDescription(desc).size();
+            }
+        }
+    }
+
+    QVERIFY(length > 0);
+}
+
+QTEST_GUILESS_MAIN(TestCleanDescription)
+
+#include "testcleandescription.moc"
@@ -0,0 +1,216 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "dateparser.h"
+
+#include <QObject>
+#include <QTest>
+#include <QTimeZone>
+
+using namespace Qt::StringLiterals;
+
+class TestDateParser final : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+
+    void parse_data();
+    void parse();
+
+    void failureRate();
+
+    void benchmark_data();
+    void benchmark();
+
+private:
+    QStringList m_corpus;
+};
+
+namespace {
+
+QDateTime utc(int year, int month, int day, int hour, int minute, int second = 0, int msec = 0)
+{
+    return {QDate{year, month, day}, QTime{hour, minute, second, msec}, QTimeZone::UTC};
+}
+
+}
+
+void TestDateParser::initTestCase()
+{
+    // mix of the date formats found in real feeds, repeated up to 100k entries
+    const QStringList samples{
+        u"Sat, 01 Mar 2025 12:30:00 +0100"_s,
+        u"Sat, 01 Mar 2025 12:30:00 GMT"_s,
+        u"01 Mar 2025 12:30 +0000"_s,
+        u"Sat, 01 Mar 25 12:30:00 EST"_s,
+        u"2025-03-01T12:30:00Z"_s,
+        u"2025-03-01T12:30:00.123+01:00"_s,
+        u"Sa, 01 Mär 2025 12:30:00 CEST"_s,
+        u"Sat, 01 Mar 2025 12:30:00 GMT+2"_s,
+    };
+
+    constexpr qsizetype corpusSize = 100'000;
+    m_corpus.reserve(corpusSize);
+    for (qsizetype i = 0; i < corpusSize; ++i) {
+        m_corpus << samples.at(i % samples.size());
+    }
+}
+
+void TestDateParser::parse_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QDateTime>("expected");
+
+    // RFC 822 and RFC 2822
+    QTest::newRow("rfc2822") << u"Sat, 01 Mar 2025 12:30:00 +0100"_s << utc(2025, 3, 1, 11, 30);
+    QTest::newRow("rfc2822-negative-offset") << u"Sat, 01 Mar 2025 12:30:00 -0500"_s << utc(2025, 3, 1, 17, 30);
+    QTest::newRow("rfc2822-gmt") << u"Sat, 01 Mar 2025 12:30:00 GMT"_s << utc(2025, 3, 1, 12, 30);
+    QTest::newRow("rfc822-two-digit-year") << u"Sat, 01 Mar 25 12:30:00 GMT"_s << utc(2025, 3, 1, 12, 30);
+    QTest::newRow("rfc822-named-zone") << u"Sat, 01 Mar 2025 12:30:00 EST"_s << utc(2025, 3, 1, 17, 30);
+    QTest::newRow("rfc822-military-zone") << u"Sat, 01 Mar 2025 12:30:00 Z"_s << utc(2025, 3, 1, 12, 30);
+    QTest::newRow("single-digit-day") << u"Sat, 1 Mar 2025 12:30:00 +0000"_s << utc(2025, 3, 1, 12, 30);
+    QTest::newRow("no-weekday") << u"01 Mar 2025 12:30:00 +0000"_s << utc(2025, 3, 1, 12, 30);
+    QTest::newRow("full-names") << u"Saturday, 01 March 2025 12:30:00 +0000"_s << utc(2025, 3, 1, 12, 30);
+    QTest::newRow("month-first") << u"Mar 1, 2025 12:30:00 GMT"_s << utc(2025, 3, 1, 12, 30);
+    QTest::newRow("surrounding-whitespace") << u"\n  Sat, 01 Mar 2025 12:30:00 GMT  \n"_s << utc(2025, 3, 1, 12, 30);
+
+    // missing parts
+    QTest::newRow("missing-seconds") << u"Sat, 01 Mar 2025 12:30 +0100"_s << utc(2025, 3, 1, 11, 30);
+    QTest::newRow("missing-zone") << u"Sat, 01 Mar 2025 12:30:00"_s << utc(2025, 3, 1, 12, 30);
+    QTest::newRow("missing-time") << u"Sat, 01 Mar 2025"_s << utc(2025, 3, 1, 0, 0);
+
+    // malformed zones
+    QTest::newRow("gmt-plus-hours") << u"Sat, 01 Mar 2025 12:30:00 GMT+2"_s << utc(2025, 3, 1, 10, 30);
+    QTest::newRow("utc-plus-colon") << u"Sat, 01 Mar 2025 12:30:00 UTC+01:00"_s << utc(2025, 3, 1, 11, 30);
+    QTest::newRow("colon-offset") << u"Sat, 01 Mar 2025 12:30:00 +01:00"_s << utc(2025, 3, 1, 11, 30);
+    QTest::newRow("cest") << u"Sat, 01 Mar 2025 12:30:00 CEST"_s << utc(2025, 3, 1, 10, 30);
+    QTest::newRow("aest") << u"Sat, 01 Mar 2025 12:30:00 AEST"_s << utc(2025, 3, 1, 2, 30);
+
+    // localized month and weekday names
+    QTest::newRow("german") << u"Mo, 03 Mär 2025 08:00:00 +0100"_s << utc(2025, 3, 3, 7, 0);
+    QTest::newRow("german-full") << u"Montag, 3. März 2025 08:00:00 +0100"_s << utc(2025, 3, 3, 7, 0);
+    QTest::newRow("french") << u"mar. 4 févr. 2025 10:00:00 +0100"_s << utc(2025, 2, 4, 9, 0);
+    QTest::newRow("french-mars") << u"mar. 4 mars 2025 10:00:00 +0100"_s << utc(2025, 3, 4, 9, 0);
+    QTest::newRow("spanish") << u"1 de enero de 2025 10:00 +0100"_s << utc(2025, 1, 1, 9, 0);
+    QTest::newRow("italian") << u"lun, 3 marzo 2025 10:00:00 +0100"_s << utc(2025, 3, 3, 9, 0);
+    QTest::newRow("dutch") << u"3 mei 2025 10:00 +0200"_s << utc(2025, 5, 3, 8, 0);
+
+    // asctime and date(1)
+    QTest::newRow("asctime") << u"Sat Mar  1 12:30:00 2025"_s << utc(2025, 3, 1, 12, 30);
+    QTest::newRow("date") << u"Sat Mar  1 12:30:00 UTC 2025"_s << utc(2025, 3, 1, 12, 30);
+
+    // RFC 3339 and ISO 8601, also used in RSS feeds
+    QTest::newRow("rfc3339-utc") << u"2025-03-01T12:30:00Z"_s << utc(2025, 3, 1, 12, 30);
+    QTest::newRow("rfc3339-offset") << u"2025-03-01T12:30:00+01:00"_s << utc(2025, 3, 1, 11, 30);
+    QTest::newRow("rfc3339-fraction") << u"2025-03-01T12:30:00.123456Z"_s << utc(2025, 3, 1, 12, 30, 0, 123);
+    QTest::newRow("iso-lowercase") << u"2025-03-01t12:30:00z"_s << utc(2025, 3, 1, 12, 30);
+    QTest::newRow("iso-space") << u"2025-03-01 12:30:00 +0100"_s << utc(2025, 3, 1, 11, 30);
+    QTest::newRow("iso-missing-seconds") << u"2025-03-01T12:30+01:00"_s << utc(2025, 3, 1, 11, 30);
+    QTest::newRow("iso-missing-zone") << u"2025-03-01T12:30:00"_s << utc(2025, 3, 1, 12, 30);
+    QTest::newRow("iso-date-only") << u"2025-03-01"_s << utc(2025, 3, 1, 0, 0);
+
+    // unknown or ambiguous zones must not be guessed
+    QTest::newRow("unknown-zone-ist") << u"Sat, 01 Mar 2025 12:30:00 IST"_s << QDateTime{};
+    QTest::newRow("unknown-zone") << u"Sat, 01 Mar 2025 12:30:00 XYZ"_s << QDateTime{};
+
+    // invalid
+    QTest::newRow("empty") << QString{} << QDateTime{};
+    QTest::newRow("garbage") << u"not a date"_s << QDateTime{};
+    QTest::newRow("unknown-month") << u"Sat, 01 Foo 2025 12:30:00 GMT"_s << QDateTime{};
+    QTest::newRow("invalid-day") << u"Sat, 31 Feb 2025 12:30:00 GMT"_s << QDateTime{};
+    QTest::newRow("invalid-hour") << u"Sat, 01 Mar 2025 25:00:00 GMT"_s << QDateTime{};
+    QTest::newRow("invalid-iso-month") << u"2025-13-01T12:30:00Z"_s << QDateTime{};
+}
+
+void TestDateParser::parse()
+{
+    QFETCH(QString, text);
+    QFETCH(QDateTime, expected);
+
+    const QDateTime result = DateParser::parse(text);
+
+    if (expected.isValid()) {
+        QVERIFY(result.isValid());
+        QCOMPARE(result.timeSpec(), Qt::UTC);
+        QCOMPARE(result, expected);
+    } else {
+        QVERIFY(!result.isValid());
+    }
+}
+
+void TestDateParser::failureRate()
+{
+    // the formerly used QDateTime::fromString() fails on most of these variants
+    const QStringList dates{
+        u"Sat, 01 Mar 2025 12:30:00 +0100"_s,
+        u"Sat, 01 Mar 25 12:30:00 GMT"_s,
+        u"Sat, 01 Mar 2025 12:30 +0100"_s,
+        u"Sat, 01 Mar 2025 12:30:00"_s,
+        u"Sat, 01 Mar 2025 12:30:00 GMT+2"_s,
+        u"Sat, 01 Mar 2025 12:30:00 CEST"_s,
+        u"Mo, 03 Mär 2025 08:00:00 +0100"_s,
+        u"mar. 4 févr. 2025 10:00:00 +0100"_s,
+        u"1 de enero de 2025 10:00 +0100"_s,
+        u"2025-03-01T12:30:00Z"_s,
+        u"2025-03-01 12:30:00 +0100"_s,
+    };
+
+    qsizetype qtFailures = 0;
+    qsizetype parserFailures = 0;
+    for (const QString &date : dates) {
+        if (!QDateTime::fromString(date, Qt::RFC2822Date).isValid()) {
+            ++qtFailures;
+        }
+        if (!DateParser::parse(date).isValid()) {
+            ++parserFailures;
+        }
+    }
+
+    QVERIFY(qtFailures > 0);
+    QCOMPARE(parserFailures, qsizetype{0});
+}
+
+void TestDateParser::benchmark_data()
+{
+    QTest::addColumn<bool>("useQt");
+
+    QTest::newRow("DateParser::parse") << false;
+    QTest::newRow("QDateTime::fromString") << true;
+}
+
+void TestDateParser::benchmark()
+{
+    QFETCH(bool, useQt);
+
+    qsizetype valid = 0;
+
+    if (useQt) {
+        QBENCHMARK {
+            valid = 0;
+            for (const QString &date : std::as_const(m_corpus)) {
+                const QDateTime dt = date.at(4) == '-'_L1 ? QDateTime::fromString(date, Qt::ISODateWithMs)
+                                                          : QDateTime::fromString(date, Qt::RFC2822Date);
+                if (dt.isValid()) {
+                    ++valid;
+                }
+            }
+        }
+    } else {
+        QBENCHMARK {
+            valid = 0;
+            for (const QString &date : std::as_const(m_corpus)) {
+                if (DateParser::parse(date).isValid()) {
+                    ++valid;
+                }
+            }
+        }
+        QCOMPARE(valid, m_corpus.size());
+    }
+}
+
+QTEST_GUILESS_MAIN(TestDateParser)
+
+#include "testdateparser.moc"
@@ -0,0 +1,420 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "feedparser.h"
+#include "itemstore.h"
+#include "utils.h"
+
+#include <QCoreApplication>
+#include <QObject>
+#include <QRegularExpression>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTest>
+#include <QTimeZone>
+
+#include <array>
+#include <limits>
+
+using namespace Qt::StringLiterals;
+
+#define HBNST_TEST_DBCONNAME u"testdbcon"_s
+
+enum class UpsertMethod : quint8 {
+    PerRow,
+    MultiRow,
+    Copy
+};
+
+Q_DECLARE_METATYPE(UpsertMethod)
+
+/*!
+ * \brief Tests the VALUES and COPY paths of ItemStore::upsert() against each other.
+ *
+ * Requires a PostgreSQL database that is configured by the environment variables
+ * \c HBNST_TEST_DB_NAME, \c HBNST_TEST_DB_HOST, \c HBNST_TEST_DB_PORT, \c HBNST_TEST_DB_USER
+ * and \c HBNST_TEST_DB_PASS. The test is skipped if \c HBNST_TEST_DB_NAME is not set. All
+ * tables are created in a temporary schema that is dropped at the end.
+ */
+class TestItemStore final : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+
+    void roundTrip_data();
+    void roundTrip();
+
+    void longValues_data();
+    void longValues();
+
+    void benchmark_data();
+    void benchmark();
+
+private:
+    struct Result {
+        QList<QStringList> newGuids;
+        QList<QStringList> updatedGuids;
+        QStringList rows;
+    };
+
+    [[nodiscard]] QList<FeedItem> parseItems(const QByteArray &itemsXml) const;
+    [[nodiscard]] QList<FeedItem> makeItems(qsizetype count, qsizetype updateEvery = 0, qsizetype added = 0) const;
+    [[nodiscard]] Result runUpserts(qsizetype minRowsForCopy, const QList<QList<FeedItem>> &rounds);
+    [[nodiscard]] bool upsertPerRow(const QList<FeedItem> &items);
+    [[nodiscard]] QStringList tableRows() const;
+    void truncate();
+
+    QString m_schema;
+};
+
+namespace {
+
+QStringList sortedGuids(const QList<FeedItem> &items)
+{
+    QStringList guids;
+    guids.reserve(items.size());
+    for (const auto &item : items) {
+        guids << item.guid();
+    }
+    guids.sort();
+    return guids;
+}
+
+}
+
+void TestItemStore::initTestCase()
+{
+    const QString dbName = qEnvironmentVariable("HBNST_TEST_DB_NAME");
+    if (dbName.isEmpty()) {
+        QSKIP("Set HBNST_TEST_DB_NAME and the other HBNST_TEST_DB_* environment variables to run the database tests");
+    }
+    if (!QSqlDatabase::isDriverAvailable(u"QPSQL"_s)) {
+        QSKIP("The QPSQL driver is not available");
+    }
+
+    auto db = QSqlDatabase::addDatabase(u"QPSQL"_s, HBNST_TEST_DBCONNAME);
+    db.setDatabaseName(dbName);
+    db.setHostName(qEnvironmentVariable("HBNST_TEST_DB_HOST"));
+    db.setPort(qEnvironmentVariableIntValue("HBNST_TEST_DB_PORT") > 0 ? qEnvironmentVariableIntValue("HBNST_TEST_DB_PORT") : 5432);
+    db.setUserName(qEnvironmentVariable("HBNST_TEST_DB_USER"));
+    db.setPassword(qEnvironmentVariable("HBNST_TEST_DB_PASS"));
+    QVERIFY2(db.open(), qUtf8Printable(db.lastError().text()));
+
+    m_schema = u"hbnst_test_%1"_s.arg(QCoreApplication::applicationPid());
+
+    // same layout as the items table created by the migrations, without the feeds reference
+    const QStringList statements{
+        u"CREATE SCHEMA %1"_s.arg(m_schema),
+        u"SET search_path TO %1"_s.arg(m_schema),
+        u"SET TIME ZONE 'UTC'"_s,
+        uR"-(CREATE TABLE items (
+                id BIGSERIAL PRIMARY KEY,
+                "feedId" INTEGER NOT NULL,
+                guid VARCHAR(2048),
+                title VARCHAR(255),
+                description TEXT,
+                author VARCHAR(255),
+                link VARCHAR(2048),
+                "pubDate" TIMESTAMP,
+                data JSONB,
+                CONSTRAINT guid_unique UNIQUE(guid)
+            ))-"_s
+    };
+
+    QSqlQuery q{db};
+    for (const QString &statement : statements) {
+        QVERIFY2(q.exec(statement), qUtf8Printable(q.lastError().text()));
+    }
+}
+
+void TestItemStore::cleanupTestCase()
+{
+    if (!QSqlDatabase::contains(HBNST_TEST_DBCONNAME)) {
+        return;
+    }
+
+    {
+        auto db = QSqlDatabase::database(HBNST_TEST_DBCONNAME);
+        if (!m_schema.isEmpty()) {
+            QSqlQuery q{db};
+            q.exec(u"DROP SCHEMA %1 CASCADE"_s.arg(m_schema));
+        }
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(HBNST_TEST_DBCONNAME);
+}
+
+void TestItemStore::init()
+{
+    truncate();
+}
+
+void TestItemStore::truncate()
+{
+    QSqlQuery q{QSqlDatabase::database(HBNST_TEST_DBCONNAME)};
+    QVERIFY2(q.exec(u"TRUNCATE items RESTART IDENTITY"_s), qUtf8Printable(q.lastError().text()));
+}
+
+QList<FeedItem> TestItemStore::makeItems(qsizetype count, qsizetype updateEvery, qsizetype added) const
+{
+    const QDateTime basePubDate{QDate{2025, 3, 1}, QTime{12, 0}, QTimeZone::UTC};
+
+    QByteArray xml;
+    xml.reserve((count + added) * 400);
+
+    for (qsizetype i = 0; i < count + added; ++i) {
+        const bool updated = updateEvery > 0 && i < count && i % updateEvery == 0;
+        const QDateTime pubDate = basePubDate.addSecs(i * 60 + (updated ? 3600 : 0));
+        const QByteArray id = QByteArray::number(i);
+
+        xml.append("<item><title>Item ");
+        xml.append(id);
+        if (updated) {
+            xml.append(" updated");
+        }
+        xml.append("</title>");
+        // some items have no link to check that both upsert paths store the same for it
+        if (i % 7 != 3) {
+            xml.append("<link>https://example.com/items/");
+            xml.append(id);
+            xml.append("</link>");
+        }
+        xml.append("<guid>https://example.com/items/");
+        xml.append(id);
+        xml.append("</guid><description>&lt;p&gt;Description of &lt;b&gt;item ");
+        xml.append(id);
+        xml.append("&lt;/b&gt; with some &amp;amp; entities.&lt;/p&gt;</description><author>author@example.com (Author)</author><pubDate>");
+        xml.append(pubDate.toString(Qt::RFC2822Date).toLatin1());
+        xml.append("</pubDate></item>");
+    }
+
+    return parseItems(xml);
+}
+
+QList<FeedItem> TestItemStore::parseItems(const QByteArray &itemsXml) const
+{
+    // items can only be created by the parser, so they are wrapped into an RSS document
+    QList<FeedItem> items;
+    FeedParser parser;
+    QObject::connect(&parser, &FeedParser::feedParsed, &parser, [&items](const Feed &feed){
+        items = feed.items();
+    });
+    parser.addData(R"(<?xml version="1.0" encoding="UTF-8"?><rss version="2.0"><channel><title>Test</title><link>https://example.com/</link><description>Test feed</description>)");
+    parser.addData(itemsXml);
+    parser.addData("</channel></rss>");
+    parser.finish();
+
+    if (parser.hasError()) {
+        qWarning("Failed to parse generated feed: %s", qUtf8Printable(parser.errorString()));
+    }
+
+    return items;
+}
+
+TestItemStore::Result TestItemStore::runUpserts(qsizetype minRowsForCopy, const QList<QList<FeedItem>> &rounds)
+{
+    Result result;
+
+    ItemStore store{HBNST_TEST_DBCONNAME};
+    store.setMinRowsForCopy(minRowsForCopy);
+    store.setCheckUnchanged(false);
+
+    for (const auto &items : rounds) {
+        QList<FeedItem> newItems;
+        QList<FeedItem> updatedItems;
+        if (!store.upsert(1, items, &newItems, &updatedItems)) {
+            qWarning("Failed to upsert items: %s", qUtf8Printable(store.lastError().text()));
+            return {};
+        }
+        result.newGuids << sortedGuids(newItems);
+        result.updatedGuids << sortedGuids(updatedItems);
+    }
+
+    result.rows = tableRows();
+
+    return result;
+}
+
+QStringList TestItemStore::tableRows() const
+{
+    QSqlQuery q{QSqlDatabase::database(HBNST_TEST_DBCONNAME)};
+    q.setForwardOnly(true);
+    if (!q.exec(uR"-(SELECT "feedId", guid, title, description, author, link, "pubDate" FROM items ORDER BY guid)-"_s)) {
+        qWarning("Failed to query items: %s", qUtf8Printable(q.lastError().text()));
+        return {};
+    }
+
+    QStringList rows;
+    while (q.next()) {
+        QStringList row;
+        row.reserve(7);
+        for (int i = 0; i < 6; ++i) {
+            // distinguish NULL from empty strings, the upsert paths have to write the same
+            row << (q.isNull(i) ? u"<NULL>"_s : q.value(i).toString());
+        }
+        row << q.value(6).toDateTime().toString(Qt::ISODate);
+        rows << row.join(u'|');
+    }
+    return rows;
+}
+
+bool TestItemStore::upsertPerRow(const QList<FeedItem> &items)
+{
+    QSqlQuery q{QSqlDatabase::database(HBNST_TEST_DBCONNAME)};
+    if (!q.prepare(uR"-(INSERT INTO items ("feedId", guid, title, description, author, link, "pubDate") VALUES (?, ?, ?, ?, ?, ?, ?)
+                         ON CONFLICT (guid) DO UPDATE SET title = excluded.title, description = excluded.description, author = excluded.author, link = excluded.link, "pubDate" = excluded."pubDate"
+                         WHERE excluded."pubDate" > items."pubDate"
+                         RETURNING id, guid, (xmax = 0) AS inserted)-"_s)) {
+        return false;
+    }
+
+    for (const auto &item : items) {
+        q.addBindValue(1);
+        q.addBindValue(item.guid());
+        q.addBindValue(item.title());
+        q.addBindValue(Utils::cleanDescription(item.description()));
+        q.addBindValue(item.author());
+        q.addBindValue(item.link());
+        q.addBindValue(item.pubDate());
+        if (!q.exec()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void TestItemStore::roundTrip_data()
+{
+    QTest::addColumn<qsizetype>("count");
+
+    QTest::newRow("10") << qsizetype{10};
+    QTest::newRow("1200") << qsizetype{1200};
+}
+
+void TestItemStore::roundTrip()
+{
+#ifndef WITH_LIBPQ
+    QSKIP("Built without libpq, there is no COPY path to compare");
+#else
+    QFETCH(qsizetype, count);
+
+    // the second round updates every third item and adds some new ones
+    const QList<QList<FeedItem>> rounds{
+        makeItems(count),
+        makeItems(count, 3, count / 10 + 1)
+    };
+    QCOMPARE(rounds.at(0).size(), count);
+    QCOMPARE(rounds.at(1).size(), count + count / 10 + 1);
+
+    const Result values = runUpserts(std::numeric_limits<qsizetype>::max(), rounds);
+    truncate();
+    const Result copy = runUpserts(1, rounds);
+
+    QCOMPARE(values.newGuids.size(), rounds.size());
+    QCOMPARE(values.newGuids.at(0), sortedGuids(rounds.at(0)));
+    QVERIFY(values.updatedGuids.at(0).isEmpty());
+    QCOMPARE(values.newGuids.at(1).size(), count / 10 + 1);
+    QCOMPARE(values.updatedGuids.at(1).size(), (count + 2) / 3);
+    QCOMPARE(values.rows.size(), count + count / 10 + 1);
+
+    QCOMPARE(copy.newGuids, values.newGuids);
+    QCOMPARE(copy.updatedGuids, values.updatedGuids);
+    QCOMPARE(copy.rows, values.rows);
+#endif
+}
+
+void TestItemStore::longValues_data()
+{
+    QTest::addColumn<qsizetype>("minRowsForCopy");
+
+    QTest::newRow("values") << std::numeric_limits<qsizetype>::max();
+#ifdef WITH_LIBPQ
+    QTest::newRow("copy") << qsizetype{1};
+#endif
+}
+
+void TestItemStore::longValues()
+{
+    QFETCH(qsizetype, minRowsForCopy);
+
+    const QByteArray pubDate = "<pubDate>Sat, 01 Mar 2025 12:00:00 GMT</pubDate>";
+    const QByteArray xml = "<item><title>" + QByteArray(300, 'T') + "</title>"
+                           "<author>" + QByteArray(300, 'A') + "</author>"
+                           "<link>https://example.com/" + QByteArray(2100, 'l') + "</link>"
+                           "<guid>https://example.com/long</guid>" + pubDate + "</item>"
+                           "<item><title>Too long guid</title><guid>https://example.com/" + QByteArray(2100, 'g') + "</guid>" + pubDate + "</item>"
+                           "<item><title>Short</title><guid>https://example.com/short</guid>" + pubDate + "</item>";
+    const QList<FeedItem> items = parseItems(xml);
+    QCOMPARE(items.size(), 3);
+
+    ItemStore store{HBNST_TEST_DBCONNAME};
+    store.setMinRowsForCopy(minRowsForCopy);
+    store.setCheckUnchanged(false);
+
+    // a single item with too long values must not fail the other ones
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression{u"^Skipping item with guid"_s});
+    QList<FeedItem> newItems;
+    QVERIFY2(store.upsert(1, items, &newItems), qUtf8Printable(store.lastError().text()));
+    QCOMPARE(sortedGuids(newItems), (QStringList{u"https://example.com/long"_s, u"https://example.com/short"_s}));
+
+    QSqlQuery q{QSqlDatabase::database(HBNST_TEST_DBCONNAME)};
+    QVERIFY2(q.exec(u"SELECT char_length(title), char_length(author), char_length(link) FROM items WHERE guid = 'https://example.com/long'"_s),
+             qUtf8Printable(q.lastError().text()));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 255);
+    QCOMPARE(q.value(1).toInt(), 255);
+    QCOMPARE(q.value(2).toInt(), 2048);
+}
+
+void TestItemStore::benchmark_data()
+{
+    QTest::addColumn<UpsertMethod>("method");
+    QTest::addColumn<qsizetype>("count");
+
+    const std::array<qsizetype,3> counts{1'000, 10'000, 100'000};
+    for (const qsizetype count : counts) {
+        QTest::addRow("per-row %lld", count) << UpsertMethod::PerRow << count;
+        QTest::addRow("multi-row %lld", count) << UpsertMethod::MultiRow << count;
+        QTest::addRow("copy %lld", count) << UpsertMethod::Copy << count;
+    }
+}
+
+void TestItemStore::benchmark()
+{
+    QFETCH(UpsertMethod, method);
+    QFETCH(qsizetype, count);
+
+#ifndef WITH_LIBPQ
+    if (method == UpsertMethod::Copy) {
+        QSKIP("Built without libpq");
+    }
+#endif
+
+    const QList<FeedItem> items = makeItems(count);
+    QCOMPARE(items.size(), count);
+
+    auto db = QSqlDatabase::database(HBNST_TEST_DBCONNAME);
+    ItemStore store{HBNST_TEST_DBCONNAME};
+    store.setCheckUnchanged(false);
+    store.setMinRowsForCopy(method == UpsertMethod::Copy ? 1 : std::numeric_limits<qsizetype>::max());
+
+    // every iteration starts with an empty table, so all items are inserted
+    QBENCHMARK {
+        truncate();
+        QVERIFY(db.transaction());
+        const bool ok = method == UpsertMethod::PerRow ? upsertPerRow(items) : store.upsert(1, items);
+        QVERIFY(ok);
+        QVERIFY(db.commit());
+    }
+}
+
+QTEST_GUILESS_MAIN(TestItemStore)
+
+#include "testitemstore.moc"
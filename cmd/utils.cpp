@@ -5,11 +5,13 @@
 
 #include "utils.h"
 
-#include <QJsonObject>
-#include <QJsonValue>
+#include <QHash>
 #include <QLocale>
 #include <QRegularExpression>
-#include <QSqlRecord>
+#include <QUrlQuery>
+
+#include <algorithm>
+#include <array>
 
 using namespace Qt::StringLiterals;
 
@@ -24,7 +26,190 @@ static constexpr char16_t ascii_underscore{95};
 static constexpr char16_t ascii_a{97};
 static constexpr char16_t ascii_z{122};
 
-static QRegularExpression tagRegEx{u"<[^>]*>"_s};
+namespace {
+
+struct NamedEntity {
+    QLatin1StringView name;
+    char16_t ch;
+};
+
+constexpr std::array<NamedEntity,40> namedEntities{{
+    {"amp"_L1, u'&'}, {"lt"_L1, u'<'}, {"gt"_L1, u'>'}, {"quot"_L1, u'"'}, {"apos"_L1, u'\''},
+    {"nbsp"_L1, u' '}, {"shy"_L1, 0}, {"hellip"_L1, u'…'}, {"mdash"_L1, u'—'}, {"ndash"_L1, u'–'},
+    {"lsquo"_L1, u'‘'}, {"rsquo"_L1, u'’'}, {"sbquo"_L1, u'‚'}, {"ldquo"_L1, u'“'}, {"rdquo"_L1, u'”'},
+    {"bdquo"_L1, u'„'}, {"laquo"_L1, u'«'}, {"raquo"_L1, u'»'}, {"copy"_L1, u'©'}, {"reg"_L1, u'®'},
+    {"trade"_L1, u'™'}, {"euro"_L1, u'€'}, {"deg"_L1, u'°'}, {"middot"_L1, u'·'}, {"bull"_L1, u'•'},
+    {"auml"_L1, u'ä'}, {"ouml"_L1, u'ö'}, {"uuml"_L1, u'ü'}, {"Auml"_L1, u'Ä'}, {"Ouml"_L1, u'Ö'},
+    {"Uuml"_L1, u'Ü'}, {"szlig"_L1, u'ß'}, {"eacute"_L1, u'é'}, {"egrave"_L1, u'è'}, {"agrave"_L1, u'à'},
+    {"ccedil"_L1, u'ç'}, {"aacute"_L1, u'á'}, {"iacute"_L1, u'í'}, {"oacute"_L1, u'ó'}, {"ntilde"_L1, u'ñ'}
+}};
+
+// tags that separate text visually, they are replaced by a space instead of being removed
+constexpr std::array<QLatin1StringView,20> blockTags{{
+    "p"_L1, "br"_L1, "div"_L1, "li"_L1, "ul"_L1, "ol"_L1, "h1"_L1, "h2"_L1, "h3"_L1, "h4"_L1,
+    "h5"_L1, "h6"_L1, "tr"_L1, "td"_L1, "th"_L1, "table"_L1, "blockquote"_L1, "hr"_L1, "figure"_L1, "img"_L1
+}};
+
+/*!
+ * \internal
+ * \brief Collects the text of an HTML fragment with collapsed white space.
+ */
+class TextCollector
+{
+public:
+    TextCollector(qsizetype capacity, qsizetype maxLength)
+        : m_maxLength{maxLength}
+    {
+        m_text.reserve(maxLength > 0 ? std::min(capacity, maxLength + 1) : capacity);
+    }
+
+    void append(QChar ch)
+    {
+        if (ch.isSpace()) {
+            m_pendingSpace = !m_text.isEmpty();
+            return;
+        }
+        if (m_pendingSpace) {
+            m_text.append(QChar::Space);
+            m_pendingSpace = false;
+        }
+        m_text.append(ch);
+    }
+
+    void appendCodePoint(char32_t ucs4)
+    {
+        if (QChar::requiresSurrogates(ucs4)) {
+            append(QChar{QChar::highSurrogate(ucs4)});
+            m_text.append(QChar{QChar::lowSurrogate(ucs4)});
+        } else if (ucs4 != 0) {
+            append(QChar{static_cast<char16_t>(ucs4)});
+        }
+    }
+
+    void space()
+    {
+        m_pendingSpace = !m_text.isEmpty();
+    }
+
+    /*!
+     * \brief Returns \c true if the text is longer than the maximum length and collecting can be stopped.
+     */
+    [[nodiscard]] bool full() const noexcept
+    {
+        return m_maxLength > 0 && m_text.size() > m_maxLength;
+    }
+
+    QString take()
+    {
+        if (full()) {
+            // cut at the last word boundary and mark the truncation
+            qsizetype cut = m_maxLength - 1;
+            const qsizetype lastSpace = m_text.lastIndexOf(QChar::Space, cut);
+            if (lastSpace > m_maxLength / 2) {
+                cut = lastSpace;
+            } else if (cut > 0 && m_text.at(cut - 1).isHighSurrogate()) {
+                --cut;
+            }
+            m_text.truncate(cut);
+            m_text.append(u'…');
+        }
+        return std::move(m_text);
+    }
+
+private:
+    QString m_text;
+    qsizetype m_maxLength{0};
+    bool m_pendingSpace{false};
+};
+
+/*!
+ * \internal
+ * \brief Returns the position after the first occurence of \a needle at or after \a from.
+ */
+qsizetype skipPast(QStringView str, qsizetype from, QLatin1StringView needle)
+{
+    const qsizetype idx = str.indexOf(needle, from, Qt::CaseInsensitive);
+    return idx < 0 ? str.size() : idx + needle.size();
+}
+
+/*!
+ * \internal
+ * \brief Returns the position after the \c > that closes the tag starting at \a from.
+ *
+ * Quoted attribute values can contain \c > characters.
+ */
+qsizetype skipTag(QStringView str, qsizetype from)
+{
+    QChar quote;
+    for (qsizetype i = from; i < str.size(); ++i) {
+        const QChar ch = str.at(i);
+        if (!quote.isNull()) {
+            if (ch == quote) {
+                quote = QChar();
+            }
+        } else if (ch == '"'_L1 || ch == '\''_L1) {
+            quote = ch;
+        } else if (ch == '>'_L1) {
+            return i + 1;
+        }
+    }
+    return str.size();
+}
+
+bool isAsciiLetter(QChar ch) noexcept
+{
+    const auto uc = ch.unicode();
+    return (uc >= ascii_a && uc <= ascii_z) || (uc >= ascii_A && uc <= ascii_Z);
+}
+
+QStringView tagName(QStringView str, qsizetype from)
+{
+    qsizetype end = from;
+    while (end < str.size() && (isAsciiLetter(str.at(end)) || (end > from && str.at(end).isDigit()))) {
+        ++end;
+    }
+    return str.sliced(from, end - from);
+}
+
+/*!
+ * \internal
+ * \brief Decodes the character reference at \a from, that points to the character after the \c &.
+ *
+ * Returns the position after the terminating semicolon or \c -1 if there is no valid reference.
+ */
+qsizetype decodeEntity(QStringView str, qsizetype from, char32_t *ucs4)
+{
+    // the longest supported reference is a hex code point like #x10FFFF, so the search for the
+    // semicolon is bounded to not scan the rest of the text for every ampersand
+    const qsizetype length = str.sliced(from, std::min<qsizetype>(9, str.size() - from)).indexOf(u';');
+    if (length < 1) {
+        return -1;
+    }
+    const qsizetype semicolon = from + length;
+
+    const QStringView ref = str.sliced(from, length);
+    if (ref.front() == '#'_L1) {
+        bool ok = false;
+        const bool hex = ref.size() > 1 && (ref.at(1) == 'x'_L1 || ref.at(1) == 'X'_L1);
+        const uint cp = ref.sliced(hex ? 2 : 1).toUInt(&ok, hex ? 16 : 10);
+        if (!ok || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+            return -1;
+        }
+        *ucs4 = cp;
+        return semicolon + 1;
+    }
+
+    for (const auto &entity : namedEntities) {
+        if (ref == entity.name) {
+            *ucs4 = entity.ch;
+            return semicolon + 1;
+        }
+    }
+
+    return -1;
+}
+
+} // namespace
 
 QString Utils::slugify(const QString &str)
 {
@@ -49,11 +234,141 @@ QString Utils::slugify(const QString &str)
     return _str2;
 }
 
-QString Utils::cleanDescription(const QString &desc)
+QString Utils::cleanDescription(QStringView desc, qsizetype maxLength)
 {
-    QString cleaned = desc.simplified();
-    cleaned.remove(tagRegEx);
-    return cleaned;
+    TextCollector text{desc.size(), maxLength};
+
+    qsizetype i = 0;
+    while (i < desc.size() && !text.full()) {
+        const QChar ch = desc.at(i);
+
+        if (ch == '&'_L1) {
+            char32_t ucs4 = 0;
+            const qsizetype next = decodeEntity(desc, i + 1, &ucs4);
+            if (next > 0) {
+                text.appendCodePoint(ucs4);
+                i = next;
+            } else {
+                text.append(ch);
+                ++i;
+            }
+            continue;
+        }
+
+        if (ch != '<'_L1 || i + 1 >= desc.size()) {
+            text.append(ch);
+            ++i;
+            continue;
+        }
+
+        const QStringView rest = desc.sliced(i);
+        if (rest.startsWith("<!--"_L1)) {
+            i = skipPast(desc, i + 4, "-->"_L1);
+            text.space();
+        } else if (rest.startsWith("<![CDATA["_L1)) {
+            // CDATA content is plain text without character references
+            const qsizetype start = i + 9;
+            const qsizetype end = desc.indexOf("]]>"_L1, start);
+            const qsizetype stop = end < 0 ? desc.size() : end;
+            for (qsizetype j = start; j < stop && !text.full(); ++j) {
+                text.append(desc.at(j));
+            }
+            i = end < 0 ? desc.size() : end + 3;
+        } else if (isAsciiLetter(desc.at(i + 1))) {
+            const QStringView name = tagName(desc, i + 1);
+            i = skipTag(desc, i + 1);
+            if (name.compare("script"_L1, Qt::CaseInsensitive) == 0) {
+                i = skipPast(desc, i, "</script"_L1);
+                i = skipTag(desc, i);
+                text.space();
+            } else if (name.compare("style"_L1, Qt::CaseInsensitive) == 0) {
+                i = skipPast(desc, i, "</style"_L1);
+                i = skipTag(desc, i);
+                text.space();
+            } else if (std::ranges::any_of(blockTags, [name](QLatin1StringView tag){ return name.compare(tag, Qt::CaseInsensitive) == 0; })) {
+                text.space();
+            }
+        } else if (desc.at(i + 1) == '/'_L1 && i + 2 < desc.size() && isAsciiLetter(desc.at(i + 2))) {
+            const QStringView name = tagName(desc, i + 2);
+            i = skipTag(desc, i + 2);
+            if (std::ranges::any_of(blockTags, [name](QLatin1StringView tag){ return name.compare(tag, Qt::CaseInsensitive) == 0; })) {
+                text.space();
+            }
+        } else if (desc.at(i + 1) == '!'_L1 || desc.at(i + 1) == '?'_L1) {
+            // doctype and processing instructions
+            i = skipTag(desc, i + 2);
+        } else {
+            // a single < that does not start a tag
+            text.append(ch);
+            ++i;
+        }
+    }
+
+    return text.take();
+}
+
+QString Utils::normalizeUrl(const QUrl &url)
+{
+    QUrl normalized = url.adjusted(QUrl::RemoveFragment | QUrl::NormalizePathSegments);
+    normalized.setScheme(normalized.scheme().toLower());
+    normalized.setHost(normalized.host().toLower());
+
+    if ((normalized.scheme() == "https"_L1 && normalized.port() == 443) || (normalized.scheme() == "http"_L1 && normalized.port() == 80)) {
+        normalized.setPort(-1);
+    }
+
+    if (normalized.path().isEmpty()) {
+        normalized.setPath(u"/"_s);
+    }
+
+    if (normalized.hasQuery()) {
+        QUrlQuery query{normalized};
+        const auto items = query.queryItems(QUrl::FullyEncoded);
+        for (const auto &item : items) {
+            const QString &key = item.first;
+            if (key.startsWith("utm_"_L1) || key == "fbclid"_L1 || key == "gclid"_L1 || key == "mc_cid"_L1 || key == "mc_eid"_L1) {
+                query.removeAllQueryItems(key);
+            }
+        }
+        normalized.setQuery(query.isEmpty() ? QString() : query.query(QUrl::FullyEncoded), QUrl::StrictMode);
+    }
+
+    return normalized.toString(QUrl::FullyEncoded);
+}
+
+QString Utils::searchConfig(const QString &language)
+{
+    // the text search configurations that are built into PostgreSQL since version 12
+    static const QHash<QString,QString> configs{
+        {u"ar"_s, u"arabic"_s},
+        {u"da"_s, u"danish"_s},
+        {u"de"_s, u"german"_s},
+        {u"el"_s, u"greek"_s},
+        {u"en"_s, u"english"_s},
+        {u"es"_s, u"spanish"_s},
+        {u"fi"_s, u"finnish"_s},
+        {u"fr"_s, u"french"_s},
+        {u"ga"_s, u"irish"_s},
+        {u"hu"_s, u"hungarian"_s},
+        {u"id"_s, u"indonesian"_s},
+        {u"it"_s, u"italian"_s},
+        {u"lt"_s, u"lithuanian"_s},
+        {u"nb"_s, u"norwegian"_s},
+        {u"ne"_s, u"nepali"_s},
+        {u"nl"_s, u"dutch"_s},
+        {u"nn"_s, u"norwegian"_s},
+        {u"no"_s, u"norwegian"_s},
+        {u"pt"_s, u"portuguese"_s},
+        {u"ro"_s, u"romanian"_s},
+        {u"ru"_s, u"russian"_s},
+        {u"sv"_s, u"swedish"_s},
+        {u"ta"_s, u"tamil"_s},
+        {u"tr"_s, u"turkish"_s}
+    };
+
+    // RSS uses language codes like de-DE or en-us
+    const QString lang = language.section(QRegularExpression(u"[-_]"_s), 0, 0).trimmed().toLower();
+    return configs.value(lang, u"simple"_s);
 }
 
 QString Utils::coordsToDb(float latitude, float longitude)
@@ -104,24 +419,3 @@ QString Utils::humanCoords(float latitude, float longitude)
     QLocale locale;
     return u"N %1 E %2"_s.arg(locale.toString(latitude), locale.toString(longitude));
 }
-
-QJsonArray Utils::queryToJsonObjectArray(QSqlQuery &query)
-{
-    QJsonArray ret;
-    const QSqlRecord record = query.record();
-    const int columns       = record.count();
-    QStringList cols;
-    cols.reserve(columns);
-    for (int i = 0; i < columns; ++i) {
-        cols.append(record.fieldName(i));
-    }
-
-    while (query.next()) {
-        QJsonObject line;
-        for (int i = 0; i < columns; ++i) {
-            line.insert(cols.at(i), QJsonValue::fromVariant(query.value(i)));
-        }
-        ret.append(line);
-    }
-    return ret;
-}
@@ -6,9 +6,9 @@
 #ifndef HBNST_UTILS_H
 #define HBNST_UTILS_H
 
-#include <QJsonArray>
-#include <QSqlQuery>
 #include <QString>
+#include <QStringView>
+#include <QUrl>
 #include <QVariant>
 
 #include <optional>
@@ -17,7 +17,31 @@
 namespace Utils {
 
 QString slugify(const QString &str);
-QString cleanDescription(const QString &desc);
+
+/*!
+ * \brief Returns the plain text of the HTML \a desc.
+ *
+ * Tags, comments and the content of \c script and \c style elements are removed, character
+ * references are decoded and white space is collapsed. CDATA sections are kept as text.
+ * If \a maxLength is greater than \c 0, the text will be truncated at a word boundary to
+ * at most \a maxLength characters.
+ */
+QString cleanDescription(QStringView desc, qsizetype maxLength = 0);
+
+/*!
+ * \brief Returns a normalized string representation of \a url to be used as cache key.
+ *
+ * Scheme and host are lowercased, default ports, the fragment and common tracking
+ * query parameters like \c utm_source are removed.
+ */
+QString normalizeUrl(const QUrl &url);
+
+/*!
+ * \brief Returns the name of the PostgreSQL text search configuration for the feed \a language.
+ *
+ * Returns \c simple if there is no built-in configuration for the language.
+ */
+QString searchConfig(const QString &language);
 
 QString coordsToDb(float latitude, float longitude);
 std::optional<std::pair<float,float>> coordsFromDb(const QVariant &v);
@@ -26,8 +50,6 @@ inline QString humanCoords(std::pair<float,float> coords) {
     return Utils::humanCoords(coords.first, coords.second);
 }
 
-QJsonArray queryToJsonObjectArray(QSqlQuery &query);
-
 }
 
 #endif // HBNST_UTILS_H
@@ -0,0 +1,96 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef HBNSTCOMMON_KEYSETCURSOR_H
+#define HBNSTCOMMON_KEYSETCURSOR_H
+
+#include <QDateTime>
+#include <QString>
+#include <QStringView>
+
+#include <optional>
+
+/*!
+ * \brief Position in a result that is ordered descending by a timestamp and an ID.
+ *
+ * Used for keyset pagination: the next page is selected by the values of the last
+ * row of the previous page instead of an \c OFFSET, so deep pages cost the same as
+ * the first page. The string representation is the ISO 8601 timestamp in UTC and
+ * the ID separated by a comma, like \c 2025-03-01T12:00:00.000Z,1234. The timestamp
+ * part is empty for rows without timestamp.
+ */
+struct KeysetCursor
+{
+    QDateTime date;
+    qint64 id{0};
+
+    /*!
+     * \brief Parses a cursor created by toString(). Returns \c std::nullopt if \a str is invalid.
+     */
+    [[nodiscard]] static std::optional<KeysetCursor> fromString(QStringView str)
+    {
+        const qsizetype sep = str.lastIndexOf(u',');
+        if (sep < 0) {
+            return std::nullopt;
+        }
+
+        KeysetCursor cursor;
+
+        bool ok = false;
+        cursor.id = str.sliced(sep + 1).toLongLong(&ok);
+        if (!ok || cursor.id < 1) {
+            return std::nullopt;
+        }
+
+        const QStringView date = str.first(sep);
+        if (!date.isEmpty()) {
+            cursor.date = QDateTime::fromString(date.toString(), Qt::ISODateWithMs);
+            if (!cursor.date.isValid()) {
+                return std::nullopt;
+            }
+        }
+
+        return cursor;
+    }
+
+    [[nodiscard]] QString toString() const
+    {
+        QString str = date.isValid() ? date.toUTC().toString(Qt::ISODateWithMs) : QString();
+        str += u',';
+        str += QString::number(id);
+        return str;
+    }
+
+    /*!
+     * \brief Returns the SQL condition that selects the rows following this cursor.
+     *
+     * The query has to be ordered by <tt>dateColumn DESC, idColumn DESC</tt>, where
+     * PostgreSQL puts rows without date first. The \a datePlaceholder is only part of
+     * the condition and has to be bound if the cursor has a valid date.
+     */
+    [[nodiscard]] QString condition(QStringView dateColumn, QStringView idColumn, QStringView datePlaceholder, QStringView idPlaceholder) const
+    {
+        QString cond{u'('};
+        if (date.isValid()) {
+            // rows without date are NULL in the row comparison and are excluded as they come first
+            cond += dateColumn;
+            cond += u", ";
+            cond += idColumn;
+            cond += u") < (";
+            cond += datePlaceholder;
+            cond += u", ";
+        } else {
+            cond += dateColumn;
+            cond += u" IS NOT NULL OR ";
+            cond += idColumn;
+            cond += u" < ";
+        }
+        cond += idPlaceholder;
+        cond += u')';
+        return cond;
+    }
+};
+
+#endif // HBNSTCOMMON_KEYSETCURSOR_H